@@ -0,0 +1,385 @@
+// Minimal benchmark harness for expected-lite: time per operation, optional
+// Linux hardware counters via perf_event_open() and a JSON report.
+//
+// Options of a benchmark program using run_main():
+//   --filter text     only run benchmarks whose name contains text
+//   --iterations n    run each benchmark exactly n iterations (no calibration)
+//   --min-time ms     calibrate iterations to run at least ms milliseconds (default 50)
+//   --json file       write the results as JSON to file
+//   --no-counters     don't use hardware counters
+//   --list            list the benchmark names
+
+#ifndef NONSTD_EXPECTED_LITE_BENCH_HPP
+#define NONSTD_EXPECTED_LITE_BENCH_HPP
+
+#include "nonstd/expected.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined( __linux__ )
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# define bench_HAVE_PERF_EVENT  1
+#else
+# define bench_HAVE_PERF_EVENT  0
+#endif
+
+// keep a function out of line, e.g. to preserve the call depth of a workload:
+
+#if defined( __GNUC__ )
+# define bench_noinline  __attribute__((noinline))
+#elif defined( _MSC_VER )
+# define bench_noinline  __declspec(noinline)
+#else
+# define bench_noinline
+#endif
+
+namespace bench {
+
+// keep the optimizer from discarding a value or from assuming memory unchanged:
+
+#if defined( __GNUC__ )
+template< typename T >
+inline void do_not_optimize( T const & value )
+{
+    asm volatile( "" : : "r,m"( value ) : "memory" );
+}
+
+inline void clobber()
+{
+    asm volatile( "" : : : "memory" );
+}
+#else
+template< typename T >
+inline void do_not_optimize( T const & value )
+{
+    static void const * volatile sink;
+    sink = &value;
+}
+
+inline void clobber()
+{
+}
+#endif
+
+// hardware counters for cycles, instructions and branch misses, if the system permits:
+
+struct counts
+{
+    bool valid;
+    double cycles;
+    double instructions;
+    double branch_misses;
+};
+
+#if bench_HAVE_PERF_EVENT
+
+class perf_counters
+{
+public:
+    perf_counters()
+    {
+        m_fd[0] = open( PERF_COUNT_HW_CPU_CYCLES, -1 );
+        m_fd[1] = m_fd[0] >= 0 ? open( PERF_COUNT_HW_INSTRUCTIONS,  m_fd[0] ) : -1;
+        m_fd[2] = m_fd[0] >= 0 ? open( PERF_COUNT_HW_BRANCH_MISSES, m_fd[0] ) : -1;
+    }
+
+    ~perf_counters()
+    {
+        for ( int fd : m_fd )
+        {
+            if ( fd >= 0 )
+                ::close( fd );
+        }
+    }
+
+    perf_counters( perf_counters const & ) = delete;
+    perf_counters & operator=( perf_counters const & ) = delete;
+
+    bool available() const
+    {
+        return m_fd[0] >= 0 && m_fd[1] >= 0 && m_fd[2] >= 0;
+    }
+
+    void start()
+    {
+        if ( available() )
+        {
+            ioctl( m_fd[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP );
+            ioctl( m_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+        }
+    }
+
+    counts stop( double ops )
+    {
+        counts result = { false, 0, 0, 0 };
+
+        if ( ! available() )
+            return result;
+
+        ioctl( m_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+
+        // read_format PERF_FORMAT_GROUP: nr, values[nr]:
+
+        unsigned long long data[4] = { 0, 0, 0, 0 };
+
+        if ( ::read( m_fd[0], data, sizeof data ) != static_cast<ssize_t>( sizeof data ) || data[0] != 3 )
+            return result;
+
+        result.valid         = true;
+        result.cycles        = static_cast<double>( data[1] ) / ops;
+        result.instructions  = static_cast<double>( data[2] ) / ops;
+        result.branch_misses = static_cast<double>( data[3] ) / ops;
+        return result;
+    }
+
+private:
+    static int open( unsigned long long config, int group )
+    {
+        perf_event_attr attr;
+        std::memset( &attr, 0, sizeof attr );
+
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof attr;
+        attr.config         = config;
+        attr.disabled       = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP;
+
+        return static_cast<int>( ::syscall( __NR_perf_event_open, &attr, 0, -1, group, 0 ) );
+    }
+
+private:
+    int m_fd[3];
+};
+
+#else // bench_HAVE_PERF_EVENT
+
+class perf_counters
+{
+public:
+    bool available() const { return false; }
+    void start() {}
+    counts stop( double ) { counts result = { false, 0, 0, 0 }; return result; }
+};
+
+#endif // bench_HAVE_PERF_EVENT
+
+// text for a JSON string and the compiler's name:
+
+inline std::string json_escape( char const * text )
+{
+    std::string s;
+    for ( ; *text; ++text )
+    {
+        if ( *text == '"' || *text == '\\' )
+            s += '\\';
+        s += *text;
+    }
+    return s;
+}
+
+inline char const * compiler_name()
+{
+#if defined( __clang__ )
+    return "clang " __clang_version__;
+#elif defined( __GNUC__ )
+    return "gcc " __VERSION__;
+#elif defined( _MSC_VER )
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+
+// result of a single benchmark:
+
+struct result
+{
+    std::string name;
+    long long iterations;
+    double ns_per_op;
+    counts counters;
+};
+
+// benchmark registry and options:
+
+struct options
+{
+    std::string filter;
+    std::string json;
+    long long iterations = 0;
+    double min_time_ms = 50;
+    bool counters = true;
+    bool list = false;
+};
+
+class suite
+{
+public:
+    explicit suite( options const & opt )
+        : m_options( opt )
+    {}
+
+    /// measure f(), which performs ops_per_iteration operations per call:
+
+    template< typename F >
+    void run( std::string const & name, F f, int ops_per_iteration = 1 )
+    {
+        if ( m_options.filter.size() && name.find( m_options.filter ) == std::string::npos )
+            return;
+
+        if ( m_options.list )
+        {
+            std::printf( "%s\n", name.c_str() );
+            return;
+        }
+
+        long long iterations = m_options.iterations > 0 ? m_options.iterations : calibrate( f );
+
+        perf_counters counters_;
+        const bool use_counters = m_options.counters && counters_.available();
+
+        const auto start = clock::now();
+        if ( use_counters ) counters_.start();
+
+        loop( f, iterations );
+
+        counts c = use_counters ? counters_.stop( static_cast<double>( iterations ) * ops_per_iteration ) : counts{ false, 0, 0, 0 };
+        const auto stop = clock::now();
+
+        const double ops = static_cast<double>( iterations ) * ops_per_iteration;
+        result r = { name, iterations, std::chrono::duration<double, std::nano>( stop - start ).count() / ops, c };
+
+        report( r );
+        m_results.push_back( r );
+    }
+
+    std::vector<result> const & results() const
+    {
+        return m_results;
+    }
+
+    bool write_json( char const * title ) const
+    {
+        if ( m_options.json.empty() )
+            return true;
+
+        std::FILE * out = std::fopen( m_options.json.c_str(), "w" );
+        if ( ! out )
+        {
+            std::fprintf( stderr, "bench: cannot write '%s'\n", m_options.json.c_str() );
+            return false;
+        }
+
+        std::fprintf( out, "{\n  \"title\": \"%s\",\n  \"library\": \"expected-lite\",\n  \"version\": \"%s\",\n", json_escape( title ).c_str(), expected_lite_VERSION );
+        std::fprintf( out, "  \"cplusplus\": %ld,\n  \"compiler\": \"%s\",\n  \"benchmarks\": [", static_cast<long>( __cplusplus ), json_escape( compiler_name() ).c_str() );
+
+        for ( std::size_t i = 0; i < m_results.size(); ++i )
+        {
+            result const & r = m_results[i];
+
+            std::fprintf( out, "%s\n    { \"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.4f", i ? "," : "", json_escape( r.name.c_str() ).c_str(), r.iterations, r.ns_per_op );
+
+            if ( r.counters.valid )
+                std::fprintf( out, ", \"cycles_per_op\": %.4f, \"instructions_per_op\": %.4f, \"branch_misses_per_op\": %.6f }", r.counters.cycles, r.counters.instructions, r.counters.branch_misses );
+            else
+                std::fprintf( out, ", \"cycles_per_op\": null, \"instructions_per_op\": null, \"branch_misses_per_op\": null }" );
+        }
+
+        std::fprintf( out, "\n  ]\n}\n" );
+        return std::fclose( out ) == 0;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    template< typename F >
+    static void loop( F & f, long long iterations )
+    {
+        for ( long long i = 0; i < iterations; ++i )
+        {
+            f();
+            clobber();
+        }
+    }
+
+    template< typename F >
+    long long calibrate( F & f ) const
+    {
+        for ( long long iterations = 64; ; iterations *= 2 )
+        {
+            const auto start = clock::now();
+            loop( f, iterations );
+            const double ms = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+
+            if ( ms >= m_options.min_time_ms / 4 || iterations >= ( 1LL << 40 ) )
+                return static_cast<long long>( static_cast<double>( iterations ) * m_options.min_time_ms / ( ms > 0 ? ms : 1e-6 ) ) + 1;
+        }
+    }
+
+    static void report( result const & r )
+    {
+        if ( r.counters.valid )
+            std::printf( "%-52s %10.2f ns/op %10.1f cyc/op %10.1f ins/op %8.4f miss/op\n", r.name.c_str(), r.ns_per_op, r.counters.cycles, r.counters.instructions, r.counters.branch_misses );
+        else
+            std::printf( "%-52s %10.2f ns/op\n", r.name.c_str(), r.ns_per_op );
+    }
+
+private:
+    options m_options;
+    std::vector<result> m_results;
+};
+
+// parse the command line, run the benchmarks and write the JSON report:
+
+inline int run_main( int argc, char * argv[], char const * title, std::function< void( suite & ) > const & benchmarks )
+{
+    options opt;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const bool has_arg = i + 1 < argc;
+
+        if      ( ! std::strcmp( argv[i], "--filter"     ) && has_arg ) opt.filter      = argv[++i];
+        else if ( ! std::strcmp( argv[i], "--json"       ) && has_arg ) opt.json        = argv[++i];
+        else if ( ! std::strcmp( argv[i], "--iterations" ) && has_arg ) opt.iterations  = std::atoll( argv[++i] );
+        else if ( ! std::strcmp( argv[i], "--min-time"   ) && has_arg ) opt.min_time_ms = std::atof( argv[++i] );
+        else if ( ! std::strcmp( argv[i], "--no-counters") )            opt.counters    = false;
+        else if ( ! std::strcmp( argv[i], "--list"       ) )            opt.list        = true;
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--filter text] [--iterations n] [--min-time ms] [--json file] [--no-counters] [--list]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    suite s( opt );
+
+    if ( ! opt.list )
+    {
+        std::printf( "%s (expected-lite %s, C++ %ld)\n", title, expected_lite_VERSION, static_cast<long>( __cplusplus ) );
+
+        if ( opt.counters && ! perf_counters().available() )
+            std::printf( "hardware counters not available\n" );
+
+        std::printf( "\n" );
+    }
+
+    benchmarks( s );
+
+    return s.write_json( title ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace bench
+
+#endif // NONSTD_EXPECTED_LITE_BENCH_HPP
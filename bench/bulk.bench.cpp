@@ -0,0 +1,111 @@
+// Runtime benchmarks of the bulk algorithms of expected_bulk.hpp over an array
+// of expected<int, status>, per instruction set up to the one of this machine,
+// for an array without errors and with 1% errors; the time is per element.
+// Instruction set scalar is the loop a caller would write.
+//
+// Usage: expected-lite-bench-bulk [--filter text] [--iterations n] [--min-time ms] [--json file] [--no-counters] [--list]
+
+#include "bench.hpp"
+#include "nonstd/expected_bulk.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace nonstd;
+
+namespace {
+
+enum class status : unsigned char { ok, failed };
+
+using X = expected<int, status>;
+
+const std::size_t size = 4096;
+
+// size elements, an error at the last index of each period:
+
+std::vector<X> make_data( std::size_t period )
+{
+    std::vector<X> data;
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        if ( period && i % period == period - 1 ) data.push_back( make_unexpected( status::failed ) );
+        else                                      data.push_back( static_cast<int>( i ) );
+    }
+    return data;
+}
+
+char const * to_string( bulk_isa isa )
+{
+    return isa == bulk_isa::avx512bw ? "avx512bw"
+         : isa == bulk_isa::avx2     ? "avx2"
+         : isa == bulk_isa::sse2     ? "sse2"
+         :                             "scalar";
+}
+
+void algorithms( bench::suite & s, char const * data_name, std::vector<X> const & data, bulk_isa isa )
+{
+    const std::string suffix = std::string( ": " ) + data_name + ", " + to_string( isa );
+    const int ops = static_cast<int>( size );
+
+    X const * first = data.data();
+
+    std::vector<int> dense( size );
+    std::vector<std::size_t> values, errors;
+
+    values.reserve( size );
+    errors.reserve( size );
+
+    s.run( "count_values()" + suffix, [&]{ bench::do_not_optimize( count_values( first, size, isa ) ); }, ops );
+    s.run( "find_error()"   + suffix, [&]{ bench::do_not_optimize( find_error( first, size, isa ) ); }, ops );
+
+    s.run( "values_or()" + suffix, [&]
+    {
+        values_or( first, size, dense.data(), -1, isa );
+        bench::do_not_optimize( dense );
+    }, ops );
+
+    s.run( "partition_indices()" + suffix, [&]
+    {
+        values.clear();
+        errors.clear();
+        partition_indices( first, size, values, errors, isa );
+        bench::do_not_optimize( values );
+    }, ops );
+}
+
+// a scalar loop, the same for each instruction set:
+
+void transform( bench::suite & s, char const * data_name, std::vector<X> const & data )
+{
+    std::vector< expected<int, status> > out( size );
+
+    s.run( std::string( "transform_values(): " ) + data_name, [&]
+    {
+        transform_values( data.data(), size, out.data(), []( int x ) { return 2 * x + 1; } );
+        bench::do_not_optimize( out );
+    }, static_cast<int>( size ) );
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    return bench::run_main( argc, argv, "expected-lite bulk algorithms", []( bench::suite & s )
+    {
+        const std::vector<X> all_values = make_data( 0 );
+        const std::vector<X> some_errors = make_data( 100 );
+
+        for ( bulk_isa isa : { bulk_isa::scalar, bulk_isa::sse2, bulk_isa::avx2, bulk_isa::avx512bw } )
+        {
+            if ( isa > detected_bulk_isa() )
+                break;
+
+            algorithms( s, "no errors", all_values, isa );
+            algorithms( s, "1% errors", some_errors, isa );
+        }
+
+        transform( s, "no errors", all_values );
+        transform( s, "1% errors", some_errors );
+    } );
+}
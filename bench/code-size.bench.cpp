@@ -0,0 +1,399 @@
+// Code size of expected: compile the corpus of functions in code-size.corpus.cpp
+// in several configurations and report the size of the code (.text) and of the
+// unwind information (.eh_frame) of each function. The sizes are read from the
+// object file with binutils' readelf, hence ELF platforms only.
+//
+// The configurations are the C++ standards configured by CMake, -O2 and -Os,
+// exceptions on and off and nsel_P2505R 0 to 5. Code that is not attributed to
+// a corpus function, such as members of expected that the compiler didn't
+// inline, and the common unwind information (CIEs) is reported as '(other)'.
+//
+// With --baseline file, the program also reports the difference with the sizes
+// in file, such as bench/code-size.baseline.txt, and with --max-growth n it
+// fails if a size grew by more than n bytes. Sizes depend on the compiler:
+// differences with a baseline of another compiler are reported, but never fail.
+// --write-baseline file writes the sizes in the format of the baseline.
+//
+// The compiler, readelf, include directory, source and standards are configured by CMake.
+//
+// Usage: expected-lite-bench-code-size [--quick] [--baseline file] [--max-growth n] [--write-baseline file] [--json file]
+
+#include "bench.hpp"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef bench_CXX_COMPILER
+# error bench_CXX_COMPILER must name the compiler to measure
+#endif
+
+#ifndef bench_CXX_COMPILER_ID
+# define bench_CXX_COMPILER_ID  bench_CXX_COMPILER
+#endif
+
+#ifndef bench_READELF
+# define bench_READELF  "readelf"
+#endif
+
+#ifndef bench_STANDARDS
+# define bench_STANDARDS  "11 17 20"
+#endif
+
+namespace {
+
+char const * const object_file = "code-size.corpus.o";
+
+struct config
+{
+    int std;
+    char const * opt;
+    bool exceptions;
+    int p2505r;
+
+    // e.g. "c++17 -O2 on 5", also the key in the baseline:
+
+    std::string name() const
+    {
+        return "c++" + std::to_string( std ) + " " + opt + " " + ( exceptions ? "on" : "off" ) + " " + std::to_string( p2505r );
+    }
+};
+
+struct measurement
+{
+    std::string config;
+    std::string function;
+    long text;
+    long eh_frame;
+};
+
+struct baseline_entry
+{
+    long text;
+    long eh_frame;
+};
+
+// run a command and capture its standard output:
+
+bool run( std::string const & cmd, std::string & output )
+{
+    std::FILE * pipe = popen( cmd.c_str(), "r" );
+    if ( ! pipe )
+        return false;
+
+    char buffer[4096];
+    output.clear();
+
+    for ( std::size_t n; ( n = std::fread( buffer, 1, sizeof buffer, pipe ) ) > 0; )
+        output.append( buffer, n );
+
+    return pclose( pipe ) == 0;
+}
+
+std::string compile_command( config const & c )
+{
+    return std::string( "\"" bench_CXX_COMPILER "\" -std=c++" ) + std::to_string( c.std ) + " " + c.opt
+        + " -c -ffunction-sections" + ( c.exceptions ? "" : " -fno-exceptions" )
+        + " -Dnsel_CONFIG_SELECT_EXPECTED=nsel_EXPECTED_NONSTD -Dnsel_P2505R=" + std::to_string( c.p2505r )
+        + " -I\"" bench_INCLUDE_DIR "\" \"" bench_SOURCE "\" -o " + object_file;
+}
+
+long hex( std::string const & text )
+{
+    return std::strtol( text.c_str(), nullptr, 16 );
+}
+
+// corpus function of a code section such as .text.size_value or .text.unlikely.size_value, or (other):
+
+std::string function_of( std::string section )
+{
+    char const * const prefixes[] = { ".text.unlikely.", ".text.hot.", ".text.startup.", ".text." };
+
+    for ( auto prefix : prefixes )
+    {
+        if ( section.compare( 0, std::strlen( prefix ), prefix ) == 0 )
+        {
+            section.erase( 0, std::strlen( prefix ) );
+            break;
+        }
+    }
+    return section.compare( 0, 5, "size_" ) == 0 ? section : "(other)";
+}
+
+// sizes of the code sections, from readelf --section-headers:
+// [Nr] Name Type Address Off Size ...
+
+void add_text_sizes( std::string const & sections, std::map<std::string, measurement> & sizes )
+{
+    std::istringstream lines( sections );
+
+    for ( std::string line; std::getline( lines, line ); )
+    {
+        const std::size_t pos = line.find( ']' );
+        if ( line.find( '[' ) == std::string::npos || pos == std::string::npos )
+            continue;
+
+        std::istringstream fields( line.substr( pos + 1 ) );
+        std::string name, type, address, offset, size;
+
+        if ( fields >> name >> type >> address >> offset >> size && type == "PROGBITS"
+            && ( name == ".text" || name.compare( 0, 6, ".text." ) == 0 ) )
+        {
+            sizes[ function_of( name ) ].text += hex( size );
+        }
+    }
+}
+
+// sizes of the FDEs, attributed to the section their initial location refers to
+// via the relocation at offset 8 of the FDE; CIEs count as (other):
+// readelf --relocs:              Offset Info Type Value Name + Addend
+// readelf --debug-dump=frames:   Offset Length CIE_pointer FDE|CIE ...
+
+void add_eh_frame_sizes( std::string const & relocs, std::string const & frames, std::map<std::string, measurement> & sizes )
+{
+    std::map<long, std::string> targets;
+    std::istringstream reloc_lines( relocs );
+    bool in_eh_frame = false;
+
+    for ( std::string line; std::getline( reloc_lines, line ); )
+    {
+        if ( line.find( "Relocation section" ) != std::string::npos )
+        {
+            in_eh_frame = line.find( "'.rela.eh_frame'" ) != std::string::npos;
+            continue;
+        }
+
+        std::istringstream fields( line );
+        std::string offset, info, type, value, name;
+
+        if ( in_eh_frame && fields >> offset >> info >> type >> value >> name )
+            targets[ hex( offset ) ] = name;
+    }
+
+    std::istringstream frame_lines( frames );
+
+    for ( std::string line; std::getline( frame_lines, line ); )
+    {
+        std::istringstream fields( line );
+        std::string offset, length, pointer, kind;
+
+        if ( ! ( fields >> offset >> length >> pointer >> kind ) || ( kind != "FDE" && kind != "CIE" ) )
+            continue;
+
+        const auto target = targets.find( hex( offset ) + 8 );
+        const std::string function = kind == "FDE" && target != targets.end() ? function_of( target->second ) : "(other)";
+
+        sizes[ function ].eh_frame += hex( length ) + 4;
+    }
+}
+
+bool measure( config const & c, std::vector<measurement> & results )
+{
+    const std::string cmd = compile_command( c );
+
+    if ( std::system( cmd.c_str() ) != 0 )
+    {
+        std::fprintf( stderr, "error: compilation failed: %s\n", cmd.c_str() );
+        return false;
+    }
+
+    std::string sections, relocs, frames;
+    const std::string readelf = std::string( "\"" bench_READELF "\" -W " );
+
+    if ( ! run( readelf + "--section-headers " + object_file, sections )
+        || ! run( readelf + "--relocs "           + object_file, relocs   )
+        || ! run( readelf + "--debug-dump=frames " + object_file, frames   ) )
+    {
+        std::fprintf( stderr, "error: cannot read '%s' with " bench_READELF "\n", object_file );
+        return false;
+    }
+
+    std::map<std::string, measurement> sizes;
+
+    add_text_sizes( sections, sizes );
+    add_eh_frame_sizes( relocs, frames, sizes );
+
+    for ( auto & entry : sizes )
+    {
+        entry.second.config = c.name();
+        entry.second.function = entry.first;
+        results.push_back( entry.second );
+    }
+
+    std::remove( object_file );
+    return true;
+}
+
+// baseline: comment lines start with '#', the compiler is given as '# compiler: id':
+// std opt exceptions p2505r function text eh_frame
+
+bool read_baseline( std::string const & file, std::map<std::string, baseline_entry> & baseline, std::string & compiler )
+{
+    std::ifstream in( file.c_str() );
+    if ( ! in )
+    {
+        std::fprintf( stderr, "error: cannot read '%s'\n", file.c_str() );
+        return false;
+    }
+
+    for ( std::string line; std::getline( in, line ); )
+    {
+        if ( line.compare( 0, 12, "# compiler: " ) == 0 )
+            compiler = line.substr( 12 );
+
+        if ( line.empty() || line[0] == '#' )
+            continue;
+
+        std::istringstream fields( line );
+        std::string std, opt, exceptions, p2505r, function;
+        baseline_entry entry;
+
+        if ( fields >> std >> opt >> exceptions >> p2505r >> function >> entry.text >> entry.eh_frame )
+            baseline[ std + " " + opt + " " + exceptions + " " + p2505r + " " + function ] = entry;
+    }
+    return true;
+}
+
+bool write_baseline( std::string const & file, std::vector<measurement> const & results )
+{
+    std::FILE * out = std::fopen( file.c_str(), "w" );
+    if ( ! out )
+    {
+        std::fprintf( stderr, "error: cannot write '%s'\n", file.c_str() );
+        return false;
+    }
+
+    std::fprintf( out, "# Code size of bench/code-size.corpus.cpp, written by expected-lite-bench-code-size --write-baseline\n" );
+    std::fprintf( out, "# compiler: %s\n", bench_CXX_COMPILER_ID );
+    std::fprintf( out, "# std opt exceptions p2505r function text eh_frame\n" );
+
+    for ( auto const & m : results )
+        std::fprintf( out, "%s %s %ld %ld\n", m.config.c_str(), m.function.c_str(), m.text, m.eh_frame );
+
+    return std::fclose( out ) == 0;
+}
+
+bool write_json( std::string const & file, std::vector<measurement> const & results )
+{
+    std::FILE * out = std::fopen( file.c_str(), "w" );
+    if ( ! out )
+    {
+        std::fprintf( stderr, "error: cannot write '%s'\n", file.c_str() );
+        return false;
+    }
+
+    std::fprintf( out, "{\n  \"title\": \"code size\",\n  \"library\": \"expected-lite\",\n  \"version\": \"%s\",\n", expected_lite_VERSION );
+    std::fprintf( out, "  \"compiler\": \"%s\",\n  \"results\": [", bench::json_escape( bench_CXX_COMPILER_ID ).c_str() );
+
+    for ( std::size_t i = 0; i < results.size(); ++i )
+    {
+        measurement const & m = results[i];
+
+        std::fprintf( out, "%s\n    { \"config\": \"%s\", \"function\": \"%s\", \"text\": %ld, \"eh_frame\": %ld }"
+            , i ? "," : "", m.config.c_str(), m.function.c_str(), m.text, m.eh_frame );
+    }
+
+    std::fprintf( out, "\n  ]\n}\n" );
+    return std::fclose( out ) == 0;
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    bool quick = false;
+    long max_growth = -1;
+    std::string baseline_file, write_file, json;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const bool has_arg = i + 1 < argc;
+
+        if      ( ! std::strcmp( argv[i], "--quick"          )            ) quick = true;
+        else if ( ! std::strcmp( argv[i], "--baseline"       ) && has_arg ) baseline_file = argv[++i];
+        else if ( ! std::strcmp( argv[i], "--max-growth"     ) && has_arg ) max_growth = std::atol( argv[++i] );
+        else if ( ! std::strcmp( argv[i], "--write-baseline" ) && has_arg ) write_file = argv[++i];
+        else if ( ! std::strcmp( argv[i], "--json"           ) && has_arg ) json = argv[++i];
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--quick] [--baseline file] [--max-growth n] [--write-baseline file] [--json file]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::map<std::string, baseline_entry> baseline;
+    std::string baseline_compiler;
+
+    if ( baseline_file.size() && ! read_baseline( baseline_file, baseline, baseline_compiler ) )
+        return EXIT_FAILURE;
+
+    const bool comparable = baseline_compiler == bench_CXX_COMPILER_ID;
+
+    std::printf( "Code size of expected-lite %s, %s, in bytes\n", expected_lite_VERSION, bench_CXX_COMPILER_ID );
+
+    if ( baseline_file.size() )
+        std::printf( "Baseline %s, %s%s\n", baseline_file.c_str(), baseline_compiler.c_str(), comparable ? "" : " (other compiler, for information only)" );
+
+    // configurations, --quick: -O2 with nsel_P2505R 0 and 5 only:
+
+    std::vector<config> configs;
+    std::istringstream standards( bench_STANDARDS );
+
+    for ( int std; standards >> std; )
+        for ( auto opt : { "-O2", "-Os" } )
+            for ( bool exceptions : { true, false } )
+                for ( int p2505r = 0; p2505r <= 5; ++p2505r )
+                    if ( ! quick || ( ! std::strcmp( opt, "-O2" ) && ( p2505r == 0 || p2505r == 5 ) ) )
+                        configs.push_back( { std, opt, exceptions, p2505r } );
+
+    std::vector<measurement> results;
+    std::vector<std::string> grown;
+
+    for ( auto const & c : configs )
+    {
+        std::printf( "\n%s (std opt exceptions nsel_P2505R)\n", c.name().c_str() );
+        std::printf( "%-22s %8s %8s %8s %8s\n", "function", "text", "eh_frame", "+text", "+eh" );
+
+        const std::size_t first = results.size();
+
+        if ( ! measure( c, results ) )
+            return EXIT_FAILURE;
+
+        for ( std::size_t i = first; i < results.size(); ++i )
+        {
+            measurement const & m = results[i];
+            std::printf( "%-22s %8ld %8ld", m.function.c_str(), m.text, m.eh_frame );
+
+            const auto base = baseline.find( m.config + " " + m.function );
+
+            if ( base != baseline.end() )
+            {
+                const long text_growth = m.text     - base->second.text;
+                const long eh_growth   = m.eh_frame - base->second.eh_frame;
+
+                std::printf( " %+8ld %+8ld", text_growth, eh_growth );
+
+                if ( comparable && max_growth >= 0 && ( text_growth > max_growth || eh_growth > max_growth ) )
+                    grown.push_back( m.config + " " + m.function );
+            }
+            else if ( baseline_file.size() )
+            {
+                std::printf( " %17s", "new" );
+            }
+            std::printf( "\n" );
+        }
+    }
+
+    if ( write_file.size() && ! write_baseline( write_file, results ) )
+        return EXIT_FAILURE;
+
+    if ( json.size() && ! write_json( json, results ) )
+        return EXIT_FAILURE;
+
+    for ( auto const & g : grown )
+        std::fprintf( stderr, "error: code size grew by more than %ld bytes: %s\n", max_growth, g.c_str() );
+
+    return grown.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,120 @@
+// Translation unit for expected-lite-bench-code-size: a fixed corpus of
+// functions that use expected<T,E>, compiled but never run.
+//
+// Each function has C linkage and is compiled in its own section
+// (-ffunction-sections), so that its code and unwind information can be
+// attributed to it. Do not rename or change the functions: the sizes are
+// compared against bench/code-size.baseline.txt.
+
+#include "nonstd/expected.hpp"
+
+#include <string>
+#include <system_error>
+
+using namespace nonstd;
+
+using expected_int    = expected<int, std::error_code>;
+using expected_string = expected<std::string, int>;
+using expected_void   = expected<void, std::error_code>;
+
+extern int consume( int );
+extern expected_int produce( int );
+
+extern "C" {
+
+// access:
+
+int size_value( expected_int const & e )
+{
+    return e.value();
+}
+
+int size_deref( expected_int const & e )
+{
+    return *e;
+}
+
+int size_value_or( expected_int const & e )
+{
+    return e.value_or( -1 );
+}
+
+int size_has_value( expected_int const & e )
+{
+    return e.has_value() ? consume( *e ) : consume( e.error().value() );
+}
+
+void size_value_void( expected_void const & e )
+{
+    e.value();
+}
+
+std::size_t size_value_string( expected_string const & e )
+{
+    return e.value().size();
+}
+
+// construction, assignment and propagation:
+
+expected_int size_make_unexpected( int code )
+{
+    if ( code )
+        return make_unexpected( std::error_code( code, std::generic_category() ) );
+
+    return 42;
+}
+
+void size_copy_assign( expected_string & a, expected_string const & b )
+{
+    a = b;
+}
+
+void size_emplace( expected_string & a, char const * text )
+{
+    a.emplace( text );
+}
+
+expected_int size_try( int x )
+{
+    nsel_TRY( int v, produce( x ) );
+    return v + 1;
+}
+
+// monadic operations:
+
+#if nsel_P2505R >= 3
+
+expected_int size_and_then( expected_int const & e )
+{
+    return e.and_then( []( int v ) { return produce( v ); } );
+}
+
+expected_int size_transform( expected_int const & e )
+{
+    return e.transform( []( int v ) { return v + 1; } );
+}
+
+expected_int size_or_else( expected_int const & e )
+{
+    return e.or_else( []( std::error_code const & ) { return expected_int( 0 ); } );
+}
+
+expected<int, int> size_transform_error( expected_int const & e )
+{
+    return e.transform_error( []( std::error_code const & ec ) { return ec.value(); } );
+}
+
+#endif // nsel_P2505R >= 3
+
+#if nsel_P2505R >= 4
+
+std::error_code size_error_or( expected_int const & e )
+{
+    return e.error_or( std::error_code() );
+}
+
+#endif // nsel_P2505R >= 4
+
+} // extern "C"
+
+// end of file
@@ -0,0 +1,221 @@
+// Compile-time cost of expected.hpp: how long the compiler takes to parse the
+// header and to instantiate typical uses of expected<T,E> (compile-time.uses.cpp),
+// for each C++ standard, front end only (-fsyntax-only).
+//
+// For each standard the program compiles the translation unit in these ways:
+// - baseline: only the standard headers that expected.hpp includes,
+// - forward:  expected_fwd.hpp and function declarations that use expected,
+// - include:  expected.hpp without using it,
+// - include, minimal: same, without std::hash, monadic operations, comparison
+//                     operators and the functions that take the current exception,
+// - uses:     expected.hpp and typical uses of some twenty instantiations,
+// and reports the median of the runs. Parsing expected.hpp costs include minus
+// baseline, instantiating the uses costs uses minus include. For C++20 and
+// later it also compiles the uses with nsel_CONFIG_CONCEPTS=0 to compare the
+// requires-clauses with std::enable_if<>.
+//
+// The compiler, include directory, source and standards are configured by CMake.
+//
+// Usage: expected-lite-bench-compile-time [--runs n] [--json file]
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+# include <sys/resource.h>
+# define bench_HAVE_RUSAGE  1
+#else
+# define bench_HAVE_RUSAGE  0
+#endif
+
+#ifndef bench_CXX_COMPILER
+# error bench_CXX_COMPILER must name the compiler to measure
+#endif
+
+#ifndef bench_STANDARDS
+# define bench_STANDARDS  "11 14 17 20"
+#endif
+
+namespace {
+
+struct timing
+{
+    double wall_ms;
+    double cpu_ms;      // negative if not available
+};
+
+struct measurement
+{
+    int std;
+    std::string variant;
+    timing median;
+    double min_wall_ms;
+};
+
+// user and system time of the terminated children, in milliseconds:
+
+double children_cpu_ms()
+{
+#if bench_HAVE_RUSAGE
+    rusage usage;
+    getrusage( RUSAGE_CHILDREN, &usage );
+
+    return 1e3 * ( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) + 1e-3 * ( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec );
+#else
+    return -1;
+#endif
+}
+
+std::string command( int std, std::string const & defines )
+{
+    return std::string( "\"" bench_CXX_COMPILER "\" -std=c++" ) + std::to_string( std )
+        + " -fsyntax-only -I\"" bench_INCLUDE_DIR "\" " + defines + " \"" bench_SOURCE "\"";
+}
+
+bool compile( std::string const & cmd, timing & t )
+{
+    using clock = std::chrono::steady_clock;
+
+    const double cpu = children_cpu_ms();
+    const auto start = clock::now();
+
+    const int status = std::system( cmd.c_str() );
+
+    t.wall_ms = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+    t.cpu_ms  = cpu < 0 ? -1 : children_cpu_ms() - cpu;
+
+    return status == 0;
+}
+
+double median( std::vector<double> v )
+{
+    std::sort( v.begin(), v.end() );
+    return v.size() % 2 ? v[ v.size() / 2 ] : ( v[ v.size() / 2 - 1 ] + v[ v.size() / 2 ] ) / 2;
+}
+
+bool measure( int std, char const * variant, std::string const & defines, int runs, measurement & m )
+{
+    const std::string cmd = command( std, defines );
+
+    // first run shows the diagnostics of a failing compilation and warms the caches:
+
+    timing t;
+    if ( ! compile( cmd, t ) )
+    {
+        std::fprintf( stderr, "error: compilation failed: %s\n", cmd.c_str() );
+        return false;
+    }
+
+    std::vector<double> wall, cpu;
+
+    for ( int i = 0; i < runs; ++i )
+    {
+        compile( cmd, t );
+        wall.push_back( t.wall_ms );
+        cpu.push_back( t.cpu_ms );
+    }
+
+    m.std = std;
+    m.variant = variant;
+    m.median.wall_ms = median( wall );
+    m.median.cpu_ms = median( cpu );
+    m.min_wall_ms = *std::min_element( wall.begin(), wall.end() );
+    return true;
+}
+
+void report( measurement const & m )
+{
+    std::printf( "c++%-4d %-17s %10.1f %10.1f %10.1f\n", m.std, m.variant.c_str(), m.median.wall_ms, m.min_wall_ms, m.median.cpu_ms );
+}
+
+bool write_json( std::string const & file, std::vector<measurement> const & results, int runs )
+{
+    std::FILE * out = std::fopen( file.c_str(), "w" );
+    if ( ! out )
+    {
+        std::fprintf( stderr, "error: cannot write '%s'\n", file.c_str() );
+        return false;
+    }
+
+    std::fprintf( out, "{\n  \"title\": \"compile time\",\n  \"library\": \"expected-lite\",\n  \"version\": \"%s\",\n", expected_lite_VERSION );
+    std::fprintf( out, "  \"compiler\": \"%s\",\n  \"runs\": %d,\n  \"results\": [", bench::json_escape( bench_CXX_COMPILER ).c_str(), runs );
+
+    for ( std::size_t i = 0; i < results.size(); ++i )
+    {
+        measurement const & m = results[i];
+
+        std::fprintf( out, "%s\n    { \"std\": %d, \"variant\": \"%s\", \"median_ms\": %.1f, \"min_ms\": %.1f, \"cpu_ms\": ", i ? "," : "", m.std, m.variant.c_str(), m.median.wall_ms, m.min_wall_ms );
+
+        if ( m.median.cpu_ms < 0 )
+            std::fprintf( out, "null }" );
+        else
+            std::fprintf( out, "%.1f }", m.median.cpu_ms );
+    }
+
+    std::fprintf( out, "\n  ]\n}\n" );
+    return std::fclose( out ) == 0;
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    int runs = 5;
+    std::string json;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const bool has_arg = i + 1 < argc;
+
+        if      ( ! std::strcmp( argv[i], "--runs" ) && has_arg ) runs = std::atoi( argv[++i] );
+        else if ( ! std::strcmp( argv[i], "--json" ) && has_arg ) json = argv[++i];
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--runs n] [--json file]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    runs = std::max( runs, 1 );
+
+    std::printf( "Compile time of expected-lite %s, %s, front end only, median of %d runs\n\n", expected_lite_VERSION, bench_CXX_COMPILER, runs );
+    std::printf( "%-7s %-17s %10s %10s %10s\n", "std", "variant", "median ms", "min ms", "cpu ms" );
+
+    std::vector<measurement> results;
+    std::istringstream standards( bench_STANDARDS );
+
+    for ( int std; standards >> std; )
+    {
+        struct variant { char const * name; char const * defines; bool cpp20; };
+
+        const variant variants[] =
+        {
+            { "baseline",         "-Dbench_BASELINE",         false },
+            { "forward",          "-Dbench_FORWARD_ONLY",     false },
+            { "include",          "-Dbench_INCLUDE_ONLY",     false },
+            { "include, minimal", "-Dbench_INCLUDE_ONLY -Dnsel_CONFIG_HASH=0 -Dnsel_P2505R=0 -Dnsel_CONFIG_RELATIONAL_OPERATORS=0 -Dnsel_CONFIG_CURRENT_EXCEPTION=0", false },
+            { "uses",             "",                         false },
+            { "uses, enable_if",  "-Dnsel_CONFIG_CONCEPTS=0", true  },
+        };
+
+        for ( auto const & v : variants )
+        {
+            if ( v.cpp20 && std < 20 )
+                continue;
+
+            measurement m;
+            if ( ! measure( std, v.name, std::string( "-Dnsel_CONFIG_SELECT_EXPECTED=nsel_EXPECTED_NONSTD " ) + v.defines, runs, m ) )
+                return EXIT_FAILURE;
+
+            report( m );
+            results.push_back( m );
+        }
+    }
+
+    return json.empty() || write_json( json, results, runs ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
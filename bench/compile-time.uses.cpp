@@ -0,0 +1,140 @@
+// Translation unit for expected-lite-bench-compile-time: typical uses of
+// expected<T,E>, compiled but never run.
+//
+// -Dbench_BASELINE      include only the standard headers that expected.hpp includes
+// -Dbench_FORWARD_ONLY  include expected_fwd.hpp and declare functions with expected
+// -Dbench_INCLUDE_ONLY  include expected.hpp without using it
+
+#if defined( bench_FORWARD_ONLY )
+
+#include "nonstd/expected_fwd.hpp"
+
+#include <string>
+#include <system_error>
+
+nonstd::expected<int, std::error_code> parse( std::string const & text );
+nonstd::expected<void, std::string> store( int value );
+
+#elif defined( bench_BASELINE )
+
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#else
+
+#include "nonstd/expected.hpp"
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#endif
+
+#if !defined( bench_BASELINE ) && !defined( bench_FORWARD_ONLY ) && !defined( bench_INCLUDE_ONLY )
+
+using namespace nonstd;
+
+namespace {
+
+struct point { int x, y; };
+
+inline bool operator==( point a, point b ) { return a.x == b.x && a.y == b.y; }
+
+// the everyday operations on one instantiation:
+
+template< typename T, typename E >
+int use( T const & value, E const & error )
+{
+    expected<T, E> a( value );
+    expected<T, E> b( unexpect, error );
+    expected<T, E> c = make_unexpected( error );
+
+    expected<T, E> d( a );
+    expected<T, E> f( std::move( d ) );
+
+    a = b;
+    b = std::move( f );
+    c = value;
+    c = make_unexpected( error );
+    a.swap( c );
+    a.emplace( value );
+
+    int n = 0;
+
+    n += a.has_value() ? 1 : 0;
+    n += static_cast<bool>( b ) ? 1 : 0;
+    n += a == b ? 1 : 0;
+    n += a != c ? 1 : 0;
+    n += a == value ? 1 : 0;
+    n += b == make_unexpected( error ) ? 1 : 0;
+    n += a.value_or( value ) == value ? 1 : 0;
+    n += a ? ( *a == value ? 1 : 0 ) : ( b.error() == error ? 1 : 0 );
+
+#if nsel_USES_STD_EXPECTED || nsel_P2505R >= 3
+    auto g = a.and_then( []( T const & v ) { return expected<T, E>( v ); } )
+              .or_else( []( E const & e ) { return expected<T, E>( unexpect, e ); } )
+              .transform( []( T const & ) { return 1; } )
+              .transform_error( []( E const & e ) { return e; } );
+
+    n += g.value_or( 0 );
+#endif
+    return n;
+}
+
+template< typename E >
+int use_void( E const & error )
+{
+    expected<void, E> a;
+    expected<void, E> b( unexpect, error );
+
+    a = b;
+    a.emplace();
+    a.swap( b );
+
+    return a == b ? 1 : 0;
+}
+
+// distinct value types, for a TU that instantiates expected many times:
+
+template< int N >
+struct tag
+{
+    int v;
+    friend bool operator==( tag a, tag b ) { return a.v == b.v; }
+};
+
+#define bench_USE_TAG( N )  use( tag<N>{ N }, std::string( "error" ) )
+
+} // anonymous namespace
+
+int uses()
+{
+    return use( 42, 7 )
+        + use( point{ 1, 2 }, std::error_code() )
+        + use( std::string( "value" ), std::string( "error" ) )
+        + use( std::vector<int>( 3, 1 ), std::error_code() )
+        + use( std::make_shared<int>( 1 ), 7 )
+        + use_void( 7 )
+        + use_void( std::error_code() )
+        + bench_USE_TAG(  0 ) + bench_USE_TAG(  1 ) + bench_USE_TAG(  2 ) + bench_USE_TAG(  3 )
+        + bench_USE_TAG(  4 ) + bench_USE_TAG(  5 ) + bench_USE_TAG(  6 ) + bench_USE_TAG(  7 )
+        + bench_USE_TAG(  8 ) + bench_USE_TAG(  9 ) + bench_USE_TAG( 10 ) + bench_USE_TAG( 11 )
+        + bench_USE_TAG( 12 ) + bench_USE_TAG( 13 ) + bench_USE_TAG( 14 ) + bench_USE_TAG( 15 );
+}
+
+#endif // bench_BASELINE, bench_FORWARD_ONLY, bench_INCLUDE_ONLY
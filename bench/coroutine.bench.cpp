@@ -0,0 +1,194 @@
+// Compare error propagation via co_await with hand-written early returns.
+//
+// Both variants run a chain of `steps` fallible calls, flat (one function
+// looping over the steps) and nested (one function per step). Each variant
+// runs on the success path and with a failure half-way the chain.
+//
+// The program replaces the global operator new to count the allocations of
+// coroutine frames that the compiler did not elide.
+//
+// Usage: expected-lite-bench-coroutine [iterations]
+
+#include "nonstd/expected.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// count the calls of operator new:
+
+namespace {
+
+long allocations = 0;
+
+} // anonymous namespace
+
+void * operator new( std::size_t size )
+{
+    ++allocations;
+
+    if ( void * p = std::malloc( size ? size : 1 ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete( void * p ) noexcept
+{
+    std::free( p );
+}
+
+#if defined( __cpp_sized_deallocation )
+void operator delete( void * p, std::size_t ) noexcept
+{
+    std::free( p );
+}
+#endif
+
+#if !nsel_CONFIG_COROUTINES
+
+int main()
+{
+    std::printf( "expected-lite: coroutine support is not available, skipping benchmark.\n" );
+}
+
+#else
+
+using namespace nonstd;
+
+enum class error { failed };
+
+const int steps = 24;
+
+volatile int fail_at_sink = -1;     // keep the failure point opaque to the optimizer
+
+nsel_noinline expected<int, error> step( int x, int i, int fail_at )
+{
+    if ( i == fail_at )
+        return make_unexpected( error::failed );
+
+    return x + i;
+}
+
+// flat chain:
+
+expected<int, error> flat_manual( int fail_at )
+{
+    int x = 0;
+    for ( int i = 0; i < steps; ++i )
+    {
+        auto r = step( x, i, fail_at );
+        if ( !r )
+            return make_unexpected( r.error() );
+        x = *r;
+    }
+    return x;
+}
+
+expected<int, error> flat_coroutine( int fail_at )
+{
+    int x = 0;
+    for ( int i = 0; i < steps; ++i )
+    {
+        x = co_await step( x, i, fail_at );
+    }
+    co_return x;
+}
+
+// nested chain, one function per step:
+
+expected<int, error> nested_manual( int depth, int fail_at )
+{
+    if ( depth == 0 )
+        return 0;
+
+    auto r = nested_manual( depth - 1, fail_at );
+    if ( !r )
+        return make_unexpected( r.error() );
+
+    auto s = step( *r, depth, fail_at );
+    if ( !s )
+        return make_unexpected( s.error() );
+
+    return *s;
+}
+
+expected<int, error> nested_coroutine( int depth, int fail_at )
+{
+    if ( depth == 0 )
+        co_return 0;
+
+    int x = co_await nested_coroutine( depth - 1, fail_at );
+
+    co_return co_await step( x, depth, fail_at );
+}
+
+// measurement:
+
+struct measurement
+{
+    double ns_per_op;
+    double allocations_per_op;
+};
+
+template< typename F >
+measurement measure( long iterations, F f )
+{
+    using clock = std::chrono::steady_clock;
+
+    long sink = 0;
+    const long allocations_before = allocations;
+    const auto start = clock::now();
+
+    for ( long i = 0; i < iterations; ++i )
+    {
+        auto r = f();
+        sink += r ? *r : -1;
+    }
+
+    const auto stop = clock::now();
+    const long allocated = allocations - allocations_before;
+
+    if ( sink == 42 )
+        std::printf( " " );
+
+    return measurement{
+        std::chrono::duration<double, std::nano>( stop - start ).count() / static_cast<double>( iterations )
+        , static_cast<double>( allocated ) / static_cast<double>( iterations ) };
+}
+
+void report( char const * name, measurement manual, measurement coroutine )
+{
+    std::printf( "%-20s %12.2f %12.2f %8.2fx %12.2f\n"
+        , name, manual.ns_per_op, coroutine.ns_per_op, coroutine.ns_per_op / manual.ns_per_op, coroutine.allocations_per_op );
+}
+
+int main( int argc, char * argv[] )
+{
+    const long iterations = argc > 1 ? std::atol( argv[1] ) : 1000000L;
+
+    const int success = fail_at_sink;
+    const int failure = steps / 2 + fail_at_sink + 1;
+
+    std::printf( "expected-lite: co_await versus manual propagation, %d steps, %ld iterations (ns/op)\n\n", steps, iterations );
+    std::printf( "%-20s %12s %12s %9s %12s\n", "chain", "manual", "co_await", "ratio", "allocs/op" );
+
+    report( "flat, success"
+        , measure( iterations, [=]{ return flat_manual( success ); } )
+        , measure( iterations, [=]{ return flat_coroutine( success ); } ) );
+
+    report( "flat, failure"
+        , measure( iterations, [=]{ return flat_manual( failure ); } )
+        , measure( iterations, [=]{ return flat_coroutine( failure ); } ) );
+
+    report( "nested, success"
+        , measure( iterations, [=]{ return nested_manual( steps, success ); } )
+        , measure( iterations, [=]{ return nested_coroutine( steps, success ); } ) );
+
+    report( "nested, failure"
+        , measure( iterations, [=]{ return nested_manual( steps, failure ); } )
+        , measure( iterations, [=]{ return nested_coroutine( steps, failure ); } ) );
+}
+
+#endif // nsel_CONFIG_COROUTINES
@@ -0,0 +1,298 @@
+// Runtime benchmarks of the core operations of expected:
+// construction, copy and move for each kind of storage (copyable, move-only,
+// non-copyable and non-movable), assignment and swap for all combinations
+// of states, the accessors, value_or() and the monadic operations on success
+// and failure.
+//
+// Usage: expected-lite-bench [--filter text] [--iterations n] [--min-time ms] [--json file] [--no-counters] [--list]
+
+#include "bench.hpp"
+
+#include <memory>
+#include <new>
+#include <string>
+
+using namespace nonstd;
+
+namespace {
+
+// value that can be neither copied nor moved:
+
+struct NoCopyNoMove
+{
+    int v;
+
+    explicit NoCopyNoMove( int v_ ) noexcept : v( v_ ) {}
+
+    NoCopyNoMove( NoCopyNoMove const & ) = delete;
+    NoCopyNoMove & operator=( NoCopyNoMove const & ) = delete;
+};
+
+// a string beyond the small string optimization:
+
+std::string const text( "a text that doesn't fit in the small string buffer" );
+
+// construction, copy and move of a copyable type:
+
+template< typename T >
+void copyable( bench::suite & s, std::string const & type, T const & value )
+{
+    using X = expected<T, int>;
+
+    X const v( value );
+    X const e( unexpect, 7 );
+
+    s.run( "construct value: "   + type, [&]{ X x( value );        bench::do_not_optimize( x ); } );
+    s.run( "construct error: "   + type, [&]{ X x( unexpect, 7 );  bench::do_not_optimize( x ); } );
+    s.run( "copy-construct value: " + type, [&]{ X x( v ); bench::do_not_optimize( x ); } );
+    s.run( "copy-construct error: " + type, [&]{ X x( e ); bench::do_not_optimize( x ); } );
+
+    X mv( value );
+    X me( unexpect, 7 );
+
+    // two moves per iteration, to keep the source's content:
+
+    s.run( "move-construct value: " + type, [&]
+    {
+        X x( std::move( mv ) );
+        mv.~X();
+        new ( &mv ) X( std::move( x ) );
+        bench::do_not_optimize( mv );
+    }, 2 );
+
+    s.run( "move-construct error: " + type, [&]
+    {
+        X x( std::move( me ) );
+        me.~X();
+        new ( &me ) X( std::move( x ) );
+        bench::do_not_optimize( me );
+    }, 2 );
+}
+
+// construction and move of a move-only type:
+
+void move_only( bench::suite & s )
+{
+    using T = std::unique_ptr<int>;
+    using X = expected<T, int>;
+    std::string const type = "unique_ptr<int>";
+
+    T ptr( new int( 42 ) );
+
+    s.run( "construct value: " + type, [&]
+    {
+        X x( std::move( ptr ) );
+        bench::do_not_optimize( x );
+        ptr = std::move( *x );
+    } );
+
+    s.run( "construct error: " + type, [&]{ X x( unexpect, 7 ); bench::do_not_optimize( x ); } );
+
+    X mv( T( new int( 42 ) ) );
+    X me( unexpect, 7 );
+
+    s.run( "move-construct value: " + type, [&]
+    {
+        X x( std::move( mv ) );
+        mv.~X();
+        new ( &mv ) X( std::move( x ) );
+        bench::do_not_optimize( mv );
+    }, 2 );
+
+    s.run( "move-construct error: " + type, [&]
+    {
+        X x( std::move( me ) );
+        me.~X();
+        new ( &me ) X( std::move( x ) );
+        bench::do_not_optimize( me );
+    }, 2 );
+
+    X a( T( new int( 1 ) ) );
+    X b( T( new int( 2 ) ) );
+
+    s.run( "move-assign value=value: " + type, [&]{ a = std::move( b ); b = std::move( a ); bench::do_not_optimize( b ); }, 2 );
+}
+
+// construction in place of a type that can be neither copied nor moved:
+
+void no_copy_no_move( bench::suite & s )
+{
+    using X = expected<NoCopyNoMove, int>;
+    std::string const type = "non-copyable, non-movable";
+
+    int value = 42;
+
+    s.run( "construct value: " + type, [&]{ X x( in_place, value ); bench::do_not_optimize( x ); } );
+    s.run( "construct error: " + type, [&]{ X x( unexpect, value ); bench::do_not_optimize( x ); } );
+
+    X x( in_place, 1 );
+
+    s.run( "emplace value: " + type, [&]{ x.emplace( value ); bench::do_not_optimize( x ); } );
+}
+
+// assignment for all combinations of states:
+
+template< typename T >
+void assignment( bench::suite & s, std::string const & type, T const & value )
+{
+    using X = expected<T, int>;
+
+    X const v( value );
+    X const e( unexpect, 7 );
+
+    X a( value );
+    X b( unexpect, 3 );
+
+    s.run( "copy-assign value=value: " + type, [&]{ a = v; bench::do_not_optimize( a ); } );
+    s.run( "copy-assign error=error: " + type, [&]{ b = e; bench::do_not_optimize( b ); } );
+    s.run( "copy-assign value=error, error=value: " + type, [&]{ a = e; bench::do_not_optimize( a ); a = v; bench::do_not_optimize( a ); }, 2 );
+
+    X mv( value );
+    X me( unexpect, 7 );
+
+    s.run( "move-assign value=value: " + type, [&]{ a = std::move( mv ); mv = std::move( a ); bench::do_not_optimize( mv ); }, 2 );
+    s.run( "move-assign error=error: " + type, [&]{ b = std::move( me ); me = std::move( b ); bench::do_not_optimize( me ); }, 2 );
+
+    // rotate over three objects so that each iteration moves an error into a value and a value into an error:
+
+    X r[3] = { X( value ), X( unexpect, 7 ), X( value ) };
+    int i = 0;
+
+    s.run( "move-assign value=error, error=value: " + type, [&]
+    {
+        X & first  = r[ i ];
+        X & second = r[ i == 2 ? 0 : i + 1 ];
+        X & third  = r[ i == 0 ? 2 : i - 1 ];
+
+        third  = std::move( second );
+        second = std::move( first );
+        i = i == 2 ? 0 : i + 1;
+        bench::do_not_optimize( second );
+    }, 2 );
+
+    s.run( "assign value: " + type, [&]{ a = value; bench::do_not_optimize( a ); } );
+    s.run( "assign unexpected: " + type, [&]{ b = make_unexpected( 5 ); bench::do_not_optimize( b ); } );
+}
+
+// swap for all combinations of states:
+
+template< typename T >
+void swapping( bench::suite & s, std::string const & type, T const & value )
+{
+    using X = expected<T, int>;
+
+    X v1( value ), v2( value );
+    X e1( unexpect, 1 ), e2( unexpect, 2 );
+
+    s.run( "swap value,value: " + type, [&]{ v1.swap( v2 ); bench::do_not_optimize( v1 ); } );
+    s.run( "swap error,error: " + type, [&]{ e1.swap( e2 ); bench::do_not_optimize( e1 ); } );
+
+    // swapping a value and an error swaps their states, two swaps restore them:
+
+    s.run( "swap value,error + error,value: " + type, [&]{ v1.swap( e1 ); e1.swap( v1 ); bench::do_not_optimize( v1 ); }, 2 );
+}
+
+// the accessors, which dominate unoptimized builds, see nsel_CONFIG_DEBUG_PERF:
+
+void accessors( bench::suite & s )
+{
+    using X = expected<int, int>;
+
+    X v( 42 );
+    X e( unexpect, 7 );
+
+    s.run( "has_value(): int",  [&]{ bench::do_not_optimize( v ); bool x = v.has_value(); bench::do_not_optimize( x ); } );
+    s.run( "operator*(): int",  [&]{ bench::do_not_optimize( v ); int x = *v;             bench::do_not_optimize( x ); } );
+    s.run( "value(): int",      [&]{ bench::do_not_optimize( v ); int x = v.value();      bench::do_not_optimize( x ); } );
+    s.run( "error(): int",      [&]{ bench::do_not_optimize( e ); int x = e.error();      bench::do_not_optimize( x ); } );
+
+    using Y = expected<std::string, int>;
+
+    Y sv( text );
+
+    s.run( "operator->(): string", [&]{ bench::do_not_optimize( sv ); std::size_t x = sv->size(); bench::do_not_optimize( x ); } );
+    s.run( "operator*() &&: string", [&]
+    {
+        std::string x = *std::move( sv );
+        sv = std::move( x );
+        bench::do_not_optimize( sv );
+    } );
+
+    using V = expected<void, int>;
+
+    V vv;
+
+    s.run( "value(): void", [&]{ bench::do_not_optimize( vv ); vv.value(); } );
+}
+
+// value_or() and the monadic operations on success and failure:
+
+void observers( bench::suite & s )
+{
+    using X = expected<int, int>;
+
+    X v( 42 );
+    X e( unexpect, 7 );
+
+    s.run( "value_or success: int", [&]{ bench::do_not_optimize( v ); int x = v.value_or( 3 ); bench::do_not_optimize( x ); } );
+    s.run( "value_or failure: int", [&]{ bench::do_not_optimize( e ); int x = e.value_or( 3 ); bench::do_not_optimize( x ); } );
+
+    using Y = expected<std::string, int>;
+
+    Y sv( text );
+    Y se( unexpect, 7 );
+
+    s.run( "value_or success: string", [&]{ std::string x = sv.value_or( "fallback" ); bench::do_not_optimize( x ); } );
+    s.run( "value_or failure: string", [&]{ std::string x = se.value_or( "fallback" ); bench::do_not_optimize( x ); } );
+
+#if nsel_USES_STD_EXPECTED || nsel_P2505R >= 3
+    auto next = []( int x ) { return X( x + 1 ); };
+    auto recover = []( int x ) { return X( x ); };
+    auto plus = []( int x ) { return x + 1; };
+
+    s.run( "and_then success: int",        [&]{ bench::do_not_optimize( v ); X x = v.and_then( next );         bench::do_not_optimize( x ); } );
+    s.run( "and_then failure: int",        [&]{ bench::do_not_optimize( e ); X x = e.and_then( next );         bench::do_not_optimize( x ); } );
+    s.run( "or_else success: int",         [&]{ bench::do_not_optimize( v ); X x = v.or_else( recover );       bench::do_not_optimize( x ); } );
+    s.run( "or_else failure: int",         [&]{ bench::do_not_optimize( e ); X x = e.or_else( recover );       bench::do_not_optimize( x ); } );
+    s.run( "transform success: int",       [&]{ bench::do_not_optimize( v ); X x = v.transform( plus );        bench::do_not_optimize( x ); } );
+    s.run( "transform failure: int",       [&]{ bench::do_not_optimize( e ); X x = e.transform( plus );        bench::do_not_optimize( x ); } );
+    s.run( "transform_error success: int", [&]{ bench::do_not_optimize( v ); X x = v.transform_error( plus );  bench::do_not_optimize( x ); } );
+    s.run( "transform_error failure: int", [&]{ bench::do_not_optimize( e ); X x = e.transform_error( plus );  bench::do_not_optimize( x ); } );
+#endif
+#if nsel_USES_STD_EXPECTED || nsel_P2505R >= 4
+    s.run( "error_or success: int",        [&]{ bench::do_not_optimize( v ); int x = v.error_or( 3 );          bench::do_not_optimize( x ); } );
+    s.run( "error_or failure: int",        [&]{ bench::do_not_optimize( e ); int x = e.error_or( 3 );          bench::do_not_optimize( x ); } );
+#endif
+
+#if nsel_USES_STD_EXPECTED || nsel_P2505R >= 3
+    auto append = []( std::string const & x ) { return Y( x + "!" ); };
+    auto size = []( std::string const & x ) { return x.size(); };
+
+    s.run( "and_then success: string",     [&]{ Y x = sv.and_then( append );           bench::do_not_optimize( x ); } );
+    s.run( "and_then failure: string",     [&]{ Y x = se.and_then( append );           bench::do_not_optimize( x ); } );
+    s.run( "transform success: string",    [&]{ auto x = sv.transform( size );         bench::do_not_optimize( x ); } );
+    s.run( "transform failure: string",    [&]{ auto x = se.transform( size );         bench::do_not_optimize( x ); } );
+#endif
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    return bench::run_main( argc, argv, "expected-lite core operations", []( bench::suite & s )
+    {
+        copyable( s, "int", 42 );
+        copyable( s, "string", text );
+        move_only( s );
+        no_copy_no_move( s );
+
+        assignment( s, "int", 42 );
+        assignment( s, "string", text );
+
+        swapping( s, "int", 42 );
+        swapping( s, "string", text );
+
+        accessors( s );
+        observers( s );
+    } );
+}
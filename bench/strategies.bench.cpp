@@ -0,0 +1,358 @@
+// Compare error handling strategies on the same workload: expected, C++
+// exceptions and error codes with out-parameters.
+//
+// The workload parses and validates numeric records. A record fails with the
+// configured rate, at a random position. The parser is called through a chain
+// of depth functions, each of which propagates the error and adjusts the value.
+// A compiler barrier in each function keeps the chain from becoming a loop.
+// Each configuration reports the throughput in records per second and the
+// median (p50) and 99th percentile (p99) latency of a single call, timed with
+// std::chrono::steady_clock (its overhead is reported too).
+//
+// Build with -Dnsel_CONFIG_SELECT_EXPECTED=nsel_EXPECTED_STD and C++23 to
+// measure std::expected instead of nonstd::expected.
+//
+// Usage: expected-lite-bench-strategies [--records n] [--json file]
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+using namespace nonstd;
+
+namespace {
+
+struct parse_error
+{
+    int code;
+    std::size_t position;
+};
+
+enum { no_error = 0, bad_digit = 1, out_of_range = 2 };
+
+const long max_value = 99999999L;
+
+// expected:
+
+bench_noinline expected<long, parse_error> parse_expected( std::string const & text )
+{
+    long value = 0;
+
+    for ( std::size_t i = 0; i < text.size(); ++i )
+    {
+        const char c = text[i];
+
+        if ( c < '0' || c > '9' )
+            return make_unexpected( parse_error{ bad_digit, i } );
+
+        value = 10 * value + ( c - '0' );
+    }
+
+    if ( value > max_value )
+        return make_unexpected( parse_error{ out_of_range, text.size() } );
+
+    return value;
+}
+
+bench_noinline expected<long, parse_error> layer_expected( std::string const & text, int depth )
+{
+    if ( depth <= 1 )
+        return parse_expected( text );
+
+    nsel_TRY( long value, layer_expected( text, depth - 1 ) );
+
+    bench::clobber();
+    return value + depth;
+}
+
+// exceptions:
+
+struct parse_exception : std::exception
+{
+    parse_error error;
+
+    explicit parse_exception( parse_error e ) : error( e ) {}
+
+    char const * what() const noexcept override { return "parse error"; }
+};
+
+bench_noinline long parse_throwing( std::string const & text )
+{
+    long value = 0;
+
+    for ( std::size_t i = 0; i < text.size(); ++i )
+    {
+        const char c = text[i];
+
+        if ( c < '0' || c > '9' )
+            throw parse_exception( parse_error{ bad_digit, i } );
+
+        value = 10 * value + ( c - '0' );
+    }
+
+    if ( value > max_value )
+        throw parse_exception( parse_error{ out_of_range, text.size() } );
+
+    return value;
+}
+
+bench_noinline long layer_throwing( std::string const & text, int depth )
+{
+    if ( depth <= 1 )
+        return parse_throwing( text );
+
+    const long value = layer_throwing( text, depth - 1 );
+
+    bench::clobber();
+    return value + depth;
+}
+
+// error codes and out-parameters:
+
+bench_noinline int parse_code( std::string const & text, long & value, std::size_t & position )
+{
+    value = 0;
+
+    for ( std::size_t i = 0; i < text.size(); ++i )
+    {
+        const char c = text[i];
+
+        if ( c < '0' || c > '9' )
+        {
+            position = i;
+            return bad_digit;
+        }
+        value = 10 * value + ( c - '0' );
+    }
+
+    if ( value > max_value )
+    {
+        position = text.size();
+        return out_of_range;
+    }
+    return no_error;
+}
+
+bench_noinline int layer_code( std::string const & text, int depth, long & value, std::size_t & position )
+{
+    if ( depth <= 1 )
+        return parse_code( text, value, position );
+
+    if ( const int rc = layer_code( text, depth - 1, value, position ) )
+        return rc;
+
+    bench::clobber();
+    value += depth;
+    return no_error;
+}
+
+// one call per strategy, yielding a checksum of the outcome:
+
+long run_expected( std::string const & text, int depth )
+{
+    auto r = layer_expected( text, depth );
+    return r ? *r : -static_cast<long>( r.error().position ) - 1;
+}
+
+long run_throwing( std::string const & text, int depth )
+{
+    try
+    {
+        return layer_throwing( text, depth );
+    }
+    catch ( parse_exception const & e )
+    {
+        return -static_cast<long>( e.error.position ) - 1;
+    }
+}
+
+long run_code( std::string const & text, int depth )
+{
+    long value = 0;
+    std::size_t position = 0;
+
+    return layer_code( text, depth, value, position ) == no_error ? value : -static_cast<long>( position ) - 1;
+}
+
+// records of eight digits, of which a fraction has a bad character:
+
+std::vector<std::string> make_records( std::size_t count, int failure_percent )
+{
+    std::uint32_t seed = 12345u;
+    auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    std::vector<std::string> records( count );
+
+    for ( auto & record : records )
+    {
+        record.resize( 8 );
+
+        for ( auto & c : record )
+            c = static_cast<char>( '0' + random() % 10 );
+
+        if ( static_cast<int>( random() % 100 ) < failure_percent )
+            record[ random() % record.size() ] = 'x';
+    }
+    return records;
+}
+
+struct measurement
+{
+    char const * strategy;
+    int failure_percent;
+    int depth;
+    double records_per_second;
+    double p50_ns;
+    double p99_ns;
+    long checksum;
+};
+
+template< typename F >
+measurement measure( char const * strategy, int failure_percent, int depth, std::vector<std::string> const & records, F f )
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<double> latencies( records.size() );
+    long checksum = 0;
+
+    // warm up:
+
+    for ( std::size_t i = 0; i < records.size() && i < 1000; ++i )
+        bench::do_not_optimize( f( records[i], depth ) );
+
+    // throughput:
+
+    const auto start = clock::now();
+
+    for ( auto const & record : records )
+        checksum += f( record, depth );
+
+    const double seconds = std::chrono::duration<double>( clock::now() - start ).count();
+
+    // latency per call:
+
+    for ( std::size_t i = 0; i < records.size(); ++i )
+    {
+        const auto t0 = clock::now();
+        const long r = f( records[i], depth );
+        const auto t1 = clock::now();
+
+        bench::do_not_optimize( r );
+        latencies[i] = std::chrono::duration<double, std::nano>( t1 - t0 ).count();
+    }
+
+    std::sort( latencies.begin(), latencies.end() );
+
+    measurement m = { strategy, failure_percent, depth, static_cast<double>( records.size() ) / seconds
+        , latencies[ latencies.size() / 2 ], latencies[ latencies.size() * 99 / 100 ], checksum };
+    return m;
+}
+
+double clock_overhead_ns()
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<double> samples( 10000 );
+
+    for ( auto & sample : samples )
+    {
+        const auto t0 = clock::now();
+        const auto t1 = clock::now();
+        sample = std::chrono::duration<double, std::nano>( t1 - t0 ).count();
+    }
+
+    std::sort( samples.begin(), samples.end() );
+    return samples[ samples.size() / 2 ];
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    std::size_t count = 100000;
+    std::string json;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const bool has_arg = i + 1 < argc;
+
+        if      ( ! std::strcmp( argv[i], "--records" ) && has_arg ) count = static_cast<std::size_t>( std::atol( argv[++i] ) );
+        else if ( ! std::strcmp( argv[i], "--json"    ) && has_arg ) json  = argv[++i];
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--records n] [--json file]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    char const * const expected_name = nsel_USES_STD_EXPECTED ? "std::expected" : "nonstd::expected";
+
+    const int failure_percents[] = { 0, 1, 10, 50 };
+    const int depths[]           = { 1, 4, 16, 32 };
+
+    std::printf( "Error handling strategies, %s, expected-lite %s, C++ %ld, %zu records per configuration\n", expected_name, expected_lite_VERSION, static_cast<long>( __cplusplus ), count );
+    std::printf( "steady_clock overhead, included in the latencies: %.1f ns\n\n", clock_overhead_ns() );
+    std::printf( "%-18s %6s %6s %14s %10s %10s\n", "strategy", "fail%", "depth", "records/s", "p50 ns", "p99 ns" );
+
+    std::vector<measurement> results;
+    bool consistent = true;
+
+    for ( int failure_percent : failure_percents )
+    {
+        const std::vector<std::string> records = make_records( count, failure_percent );
+
+        for ( int depth : depths )
+        {
+            const measurement ms[] =
+            {
+                measure( expected_name,     failure_percent, depth, records, run_expected ),
+                measure( "exceptions",      failure_percent, depth, records, run_throwing ),
+                measure( "error codes",     failure_percent, depth, records, run_code     ),
+            };
+
+            for ( auto const & m : ms )
+            {
+                std::printf( "%-18s %6d %6d %14.0f %10.1f %10.1f\n", m.strategy, m.failure_percent, m.depth, m.records_per_second, m.p50_ns, m.p99_ns );
+                consistent = consistent && m.checksum == ms[0].checksum;
+                results.push_back( m );
+            }
+        }
+    }
+
+    if ( ! consistent )
+    {
+        std::fprintf( stderr, "error: strategies yield different results\n" );
+        return EXIT_FAILURE;
+    }
+
+    if ( json.size() )
+    {
+        std::FILE * out = std::fopen( json.c_str(), "w" );
+        if ( ! out )
+        {
+            std::fprintf( stderr, "error: cannot write '%s'\n", json.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        std::fprintf( out, "{\n  \"title\": \"error handling strategies\",\n  \"library\": \"expected-lite\",\n  \"version\": \"%s\",\n", expected_lite_VERSION );
+        std::fprintf( out, "  \"cplusplus\": %ld,\n  \"compiler\": \"%s\",\n  \"records\": %zu,\n  \"results\": [", static_cast<long>( __cplusplus ), bench::json_escape( bench::compiler_name() ).c_str(), count );
+
+        for ( std::size_t i = 0; i < results.size(); ++i )
+        {
+            measurement const & m = results[i];
+
+            std::fprintf( out, "%s\n    { \"strategy\": \"%s\", \"failure_percent\": %d, \"depth\": %d, \"records_per_second\": %.0f, \"p50_ns\": %.1f, \"p99_ns\": %.1f }"
+                , i ? "," : "", m.strategy, m.failure_percent, m.depth, m.records_per_second, m.p50_ns, m.p99_ns );
+        }
+
+        std::fprintf( out, "\n  ]\n}\n" );
+        std::fclose( out );
+    }
+
+    return EXIT_SUCCESS;
+}
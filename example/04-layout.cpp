@@ -0,0 +1,36 @@
+// Print the layout of several instantiations of expected: size, alignment,
+// placement of value, error and discriminant, and padding.
+
+#include "nonstd/expected_layout.hpp"
+
+#include <iostream>
+#include <string>
+#include <system_error>
+
+using namespace nonstd;
+
+// the layout is known at compile time, e.g. to size a cache:
+
+static_assert( layout_report<int, std::errc>().size == 2 * sizeof( int ), "expected<int, std::errc> takes two ints" );
+
+template< typename T, typename E >
+void print( char const * name )
+{
+    std::cout << name << ": " << layout_report<T, E>() << "\n";
+}
+
+int main()
+{
+    print< int        , std::errc       >( "expected<int, std::errc>" );
+    print< double     , int             >( "expected<double, int>" );
+    print< int *      , std::errc       >( "expected<int *, std::errc>" );
+    print< int        , std::error_code >( "expected<int, std::error_code>" );
+    print< std::string, std::error_code >( "expected<std::string, std::error_code>" );
+    print< void       , std::error_code >( "expected<void, std::error_code>" );
+}
+
+// cl -EHsc -I../include 04-layout.cpp && 04-layout.exe
+// g++ -std=c++11 -Wall -I../include -o 04-layout.exe 04-layout.cpp && 04-layout.exe
+// expected<int, std::errc>: size 8, align 4: value 4 bytes at 0, error 4 bytes at 0, discriminant flag 1 byte at 4, padding 3
+// expected<double, int>: size 16, align 8: value 8 bytes at 0, error 4 bytes at 0, discriminant flag 1 byte at 8, padding 7
+// ...
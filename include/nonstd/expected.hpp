@@ -97,6 +97,103 @@
 # define nsel_CONFIG_NO_NODISCARD  1
 #endif
 
+// Control use of the niche of std::error_code (null category) to hold the discriminant, default off:
+
+#ifndef  nsel_CONFIG_NICHE_ERROR_CODE
+# define nsel_CONFIG_NICHE_ERROR_CODE  0
+#endif
+
+// Control branch prediction hints on has_value() in accessors and monadic operations, default on:
+
+#ifndef  nsel_CONFIG_BRANCH_HINTS
+# define nsel_CONFIG_BRANCH_HINTS  1
+#endif
+
+// Control forced inlining of the accessors and the storage functions they forward to,
+// for unoptimized (-O0) debug builds, default off:
+
+#ifndef  nsel_CONFIG_DEBUG_PERF
+# define nsel_CONFIG_DEBUG_PERF  0
+#endif
+
+// Control handling of a violated precondition of operator->, operator*, error() and,
+// without exceptions, of value(); default assert():
+
+#define nsel_CONTRACT_VIOLATION_ASSERT        0
+#define nsel_CONTRACT_VIOLATION_IGNORE        1
+#define nsel_CONTRACT_VIOLATION_TRAP          2
+#define nsel_CONTRACT_VIOLATION_CALL_HANDLER  3
+#define nsel_CONTRACT_VIOLATION_LOG_ABORT     4
+
+#ifndef  nsel_CONFIG_CONTRACT_VIOLATION_HANDLER
+# define nsel_CONFIG_CONTRACT_VIOLATION_HANDLER  nsel_CONTRACT_VIOLATION_ASSERT
+#endif
+
+// Control presence of the std::hash specializations for expected, default on:
+
+#ifndef  nsel_CONFIG_HASH
+# define nsel_CONFIG_HASH  1
+#endif
+
+// Control presence of the comparison operators of expected and unexpected_type, default on:
+
+#ifndef  nsel_CONFIG_RELATIONAL_OPERATORS
+# define nsel_CONFIG_RELATIONAL_OPERATORS  1
+#endif
+
+// Control presence of make_unexpected_from_current_exception(), make_expected_from_current_exception()
+// and make_expected_from_call() (nsel_P0323R <= 3), default on:
+
+#ifndef  nsel_CONFIG_CURRENT_EXCEPTION
+# define nsel_CONFIG_CURRENT_EXCEPTION  1
+#endif
+
+// Control explicit instantiation declarations of expected for the types of nsel_CONFIG_EXTERN_TEMPLATE_TYPES,
+// defined once in library expected-lite-extern (src/expected.cpp), default off:
+
+#ifndef  nsel_CONFIG_EXTERN_TEMPLATES
+# define nsel_CONFIG_EXTERN_TEMPLATES  0
+#endif
+
+// The instantiations as X( T, E ); the types must be declared when expected.hpp is included:
+
+#ifndef  nsel_CONFIG_EXTERN_TEMPLATE_TYPES
+# define nsel_CONFIG_EXTERN_TEMPLATE_TYPES( X ) \
+    X( void,        std::error_code ) \
+    X( int,         std::errc       ) \
+    X( int,         std::error_code ) \
+    X( std::string, std::error_code )
+#endif
+
+// Control support for coroutines returning expected (C++20), default on if available:
+
+#ifndef  nsel_CONFIG_COROUTINES
+# define nsel_CONFIG_COROUTINES  nsel_HAVE_COROUTINES
+#endif
+
+// Control reuse of the coroutine frames that the compiler does not elide, per thread, default on:
+
+#ifndef  nsel_CONFIG_COROUTINE_FRAME_CACHE
+# define nsel_CONFIG_COROUTINE_FRAME_CACHE  1
+#endif
+
+// Control use of C++20 requires-clauses and std::invoke() instead of std::enable_if<>
+// and the C++11 invoke() implementation, to reduce compile time; default on if available:
+
+#ifndef  nsel_CONFIG_CONCEPTS
+# define nsel_CONFIG_CONCEPTS  nsel_HAVE_CONCEPTS
+#endif
+
+// Control use of GNU statement expressions in nsel_TRY(), default on for GCC and clang:
+
+#ifndef  nsel_CONFIG_TRY_STATEMENT_EXPRESSION
+# if defined(__GNUC__)
+#  define nsel_CONFIG_TRY_STATEMENT_EXPRESSION  1
+# else
+#  define nsel_CONFIG_TRY_STATEMENT_EXPRESSION  0
+# endif
+#endif
+
 // Control presence of C++ exception handling (try and auto discover):
 
 #ifndef nsel_CONFIG_NO_EXCEPTIONS
@@ -256,8 +353,10 @@ namespace nonstd {
 
     //[[deprecated("replace unexpected_type with unexpected")]]
 
+#ifndef NONSTD_EXPECTED_LITE_FWD_HPP
     template< typename E >
     using unexpected_type = unexpected<E>;
+#endif
 
     // Unconditionally provide make_unexpected():
 
@@ -284,8 +383,11 @@ namespace nonstd {
 #else // nsel_USES_STD_EXPECTED
 
 #include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
-#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <new>
@@ -295,6 +397,14 @@ namespace nonstd {
 
 // additional includes:
 
+#if nsel_CONFIG_HASH || nsel_P2505R >= 3
+# include <functional>
+#endif
+
+#if nsel_CONFIG_EXTERN_TEMPLATES
+# include <string>
+#endif
+
 #if nsel_CONFIG_WIN32_LEAN_AND_MEAN
 # ifndef  WIN32_LEAN_AND_MEAN
 #  define WIN32_LEAN_AND_MEAN
@@ -370,14 +480,37 @@ namespace nonstd {
 // half-open range [lo..hi):
 //#define nsel_BETWEEN( v, lo, hi ) ( (lo) <= (v) && (v) < (hi) )
 
+// Presence of C++20 concepts, for constraints via requires-clauses:
+
+#if nsel_CPP20_OR_GREATER && defined(__cpp_concepts) && __cpp_concepts >= 201907L
+# define nsel_HAVE_CONCEPTS  1
+#else
+# define nsel_HAVE_CONCEPTS  0
+#endif
+
 // Method enabling
 
+#if nsel_CONFIG_CONCEPTS
+
+// C++20: nsel_REQUIRES_T() closes the template parameter list and starts a requires-clause,
+// the closing '>' of the template parameter list completes the final detail::enabled< true >:
+
+#define nsel_REQUIRES_0(...) \
+    template< bool B = true > requires ( __VA_ARGS__ )
+
+#define nsel_REQUIRES_T(...) \
+    > requires ( __VA_ARGS__ ) && ::nonstd::expected_lite::detail::enabled< true
+
+#else // nsel_CONFIG_CONCEPTS
+
 #define nsel_REQUIRES_0(...) \
     template< bool B = (__VA_ARGS__), typename std::enable_if<B, int>::type = 0 >
 
 #define nsel_REQUIRES_T(...) \
     , typename std::enable_if< (__VA_ARGS__), int >::type = 0
 
+#endif // nsel_CONFIG_CONCEPTS
+
 #define nsel_REQUIRES_R(R, ...) \
     typename std::enable_if< (__VA_ARGS__), R>::type
 
@@ -434,11 +567,30 @@ nsel_DISABLE_MSVC_WARNINGS( 26409 )
 
 #define nsel_HAVE_ADDRESSOF   nsel_CPP11_000
 
+// Presence of C++11 library features, not in GNUC before 5.0:
+
+#define nsel_HAVE_IS_TRIVIALLY_COPYABLE  ( nsel_CPP11_000 && ( !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 500 ) )
+
 // Presence of C++17 language features:
 
 #define nsel_HAVE_DEPRECATED  nsel_CPP17_000
 #define nsel_HAVE_NODISCARD   nsel_CPP17_000
 
+// Presence of C++20 coroutines, with a compiler that converts the return object when the
+// coroutine first returns to its caller; the standard leaves this unspecified (CWG2563),
+// verified with GCC 12 and clang 14:
+
+#if nsel_CPP20_OR_GREATER && defined(__cpp_impl_coroutine) \
+    && ( nsel_COMPILER_GNUC_VERSION >= 1200 || nsel_COMPILER_CLANG_VERSION >= 1400 )
+# define nsel_HAVE_COROUTINES  1
+#else
+# define nsel_HAVE_COROUTINES  0
+#endif
+
+#if nsel_CONFIG_COROUTINES
+# include <coroutine>
+#endif
+
 // C++ feature usage:
 
 #if nsel_HAVE_DEPRECATED
@@ -453,6 +605,54 @@ nsel_DISABLE_MSVC_WARNINGS( 26409 )
 # define nsel_NODISCARD  /*[[nodiscard]]*/
 #endif
 
+// Keep failure paths out of line and out of the hot path:
+
+#if nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_CLANG_VERSION
+# define nsel_noinline  __attribute__((noinline))
+# define nsel_cold      __attribute__((cold))
+#elif nsel_COMPILER_MSVC_VERSION
+# define nsel_noinline  __declspec(noinline)
+# define nsel_cold      /*cold*/
+#else
+# define nsel_noinline  /*noinline*/
+# define nsel_cold      /*cold*/
+#endif
+
+// Accessors that cost no call in an unoptimized build, see nsel_CONFIG_DEBUG_PERF;
+// MSVC honours __forceinline at /Od only with /Ob1 or higher:
+
+#if nsel_CONFIG_DEBUG_PERF && ( nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_CLANG_VERSION )
+# define nsel_force_inline  __attribute__((always_inline))
+#elif nsel_CONFIG_DEBUG_PERF && nsel_COMPILER_MSVC_VERSION
+# define nsel_force_inline  __forceinline
+#else
+# define nsel_force_inline  /*inline*/
+#endif
+
+// std::move() and std::addressof() are calls at -O0, the cast and the builtin are not:
+
+#if nsel_CONFIG_DEBUG_PERF
+# define nsel_MOVE( x )  static_cast< typename std::remove_reference< decltype( x ) >::type && >( x )
+#else
+# define nsel_MOVE( x )  std::move( x )
+#endif
+
+#if nsel_CONFIG_DEBUG_PERF && ( nsel_COMPILER_GNUC_VERSION >= 700 || nsel_COMPILER_CLANG_VERSION )
+# define nsel_ADDRESSOF( x )  __builtin_addressof( x )
+#else
+# define nsel_ADDRESSOF( x )  std11::addressof( x )
+#endif
+
+// Branch prediction hints, usable in C++11 constexpr functions:
+
+#if nsel_CONFIG_BRANCH_HINTS && ( nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_CLANG_VERSION )
+# define nsel_LIKELY(   expr )  __builtin_expect( !!( expr ), 1 )
+# define nsel_UNLIKELY( expr )  __builtin_expect( !!( expr ), 0 )
+#else
+# define nsel_LIKELY(   expr )  ( expr )
+# define nsel_UNLIKELY( expr )  ( expr )
+#endif
+
 //
 // expected:
 //
@@ -476,6 +676,27 @@ namespace std11 {
     template< class T >
     const T * addressof( const T && ) = delete;
 #endif
+
+#if nsel_HAVE_IS_TRIVIALLY_COPYABLE
+    using std::is_trivially_copy_constructible;
+    using std::is_trivially_move_constructible;
+    using std::is_trivially_copy_assignable;
+    using std::is_trivially_move_assignable;
+#else
+    // conservative approximation: only trivial types qualify:
+
+    template< class T >
+    struct is_trivially_copy_constructible : std::integral_constant< bool, std::is_trivial<T>::value && std::is_copy_constructible<T>::value > {};
+
+    template< class T >
+    struct is_trivially_move_constructible : std::integral_constant< bool, std::is_trivial<T>::value && std::is_move_constructible<T>::value > {};
+
+    template< class T >
+    struct is_trivially_copy_assignable : std::integral_constant< bool, std::is_trivial<T>::value && std::is_copy_assignable<T>::value > {};
+
+    template< class T >
+    struct is_trivially_move_assignable : std::integral_constant< bool, std::is_trivial<T>::value && std::is_move_assignable<T>::value > {};
+#endif
 } // namespace std11
 
 // type traits C++17:
@@ -561,150 +782,196 @@ struct remove_cvref
 
 } // namespace std20
 
-// forward declaration:
+// forward declarations, unless already provided by expected_fwd.hpp:
 
-template< typename T, typename E >
+#ifndef NONSTD_EXPECTED_LITE_FWD_HPP
+
+#if nsel_P0323R <= 2
+template< typename T, typename E = std::exception_ptr >
 class expected;
 
-namespace detail {
+template< typename E = std::exception_ptr >
+class unexpected_type;
+#else
+template< typename T, typename E >
+class expected;
 
-#if nsel_P2505R >= 3
-template< typename T >
-struct is_expected : std::false_type {};
+template< typename E >
+class unexpected_type;
+#endif // nsel_P0323R
 
-template< typename T, typename E >
-struct is_expected< expected< T, E > > : std::true_type {};
-#endif // nsel_P2505R >= 3
+#endif // NONSTD_EXPECTED_LITE_FWD_HPP
 
-/// discriminated union to hold value or 'error'.
+/// niche_traits: customization point for a type to declare bytes of its object
+/// representation that hold a pattern no value of the type uses (a niche).
+/// expected<T,E> uses the niche of T or E to encode has_value(), instead of a
+/// separate flag, if the other type fits beside the niche and this saves space.
+///
+/// A specialization with has_niche true provides:
+/// - niche_offset, niche_size: position of the niche in the object representation,
+/// - is_niche( p ): true if the object representation starting at p holds the niche pattern,
+/// - set_niche( p ): write the niche pattern to the object representation starting at p.
+///
+/// Note: enabling a niche changes the layout of expected<T,E>.
 
-template< typename T, typename E >
-class storage_t_noncopy_nonmove_impl
+template< typename T >
+struct niche_traits
 {
-    template< typename, typename > friend class nonstd::expected_lite::expected;
+    static constexpr bool has_niche = false;
+};
 
-public:
-    using value_type = T;
-    using error_type = E;
+/// niche of a single byte at Offset with a value Pattern that is never used.
 
-    // no-op construction
-    storage_t_noncopy_nonmove_impl() {}
-    ~storage_t_noncopy_nonmove_impl() {}
+template< std::size_t Offset, unsigned char Pattern = 0xFF >
+struct niche_byte
+{
+    static constexpr bool        has_niche    = true;
+    static constexpr std::size_t niche_offset = Offset;
+    static constexpr std::size_t niche_size   = 1;
 
-    explicit storage_t_noncopy_nonmove_impl( bool has_value )
-        : m_has_value( has_value )
-    {}
+    nsel_force_inline static bool is_niche( unsigned char const * p ) noexcept
+    {
+        return p[ Offset ] == Pattern;
+    }
 
-    void construct_value()
+    static void set_niche( unsigned char * p ) noexcept
     {
-        new( std11::addressof(m_value) ) value_type();
+        p[ Offset ] = Pattern;
     }
+};
 
-    // void construct_value( value_type const & e )
-    // {
-    //     new( std11::addressof(m_value) ) value_type( e );
-    // }
+/// niche of a pointer at Offset that is never null.
 
-    // void construct_value( value_type && e )
-    // {
-    //     new( std11::addressof(m_value) ) value_type( std::move( e ) );
-    // }
+template< std::size_t Offset >
+struct niche_null_pointer
+{
+    static constexpr bool        has_niche    = true;
+    static constexpr std::size_t niche_offset = Offset;
+    static constexpr std::size_t niche_size   = sizeof( void * );
 
-    template< class... Args >
-    void emplace_value( Args&&... args )
+    nsel_force_inline static bool is_niche( unsigned char const * p ) noexcept
     {
-        new( std11::addressof(m_value) ) value_type( std::forward<Args>(args)...);
+        void const * ptr;
+        std::memcpy( &ptr, p + Offset, sizeof( ptr ) );
+        return ptr == nullptr;
     }
 
-    template< class U, class... Args >
-    void emplace_value( std::initializer_list<U> il, Args&&... args )
+    static void set_niche( unsigned char * p ) noexcept
     {
-        new( std11::addressof(m_value) ) value_type( il, std::forward<Args>(args)... );
+        void const * ptr = nullptr;
+        std::memcpy( p + Offset, &ptr, sizeof( ptr ) );
     }
+};
 
-    void destruct_value()
-    {
-        m_value.~value_type();
-    }
+#if nsel_CONFIG_NICHE_ERROR_CODE
 
-    // void construct_error( error_type const & e )
-    // {
-    //     // new( std11::addressof(m_error) ) error_type( e );
-    // }
+/// std::error_code, a valid error_code always refers to a category.
+/// Assumes the common layout { int value; error_category const * category; }.
 
-    // void construct_error( error_type && e )
-    // {
-    //     // new( std11::addressof(m_error) ) error_type( std::move( e ) );
-    // }
+template<>
+struct niche_traits< std::error_code > : niche_null_pointer< sizeof( std::error_code ) - sizeof( void * ) >
+{
+    static_assert( sizeof( std::error_code ) == 2 * sizeof( void * ) || sizeof( std::error_code ) == sizeof( int ) + sizeof( void * )
+        , "nsel_CONFIG_NICHE_ERROR_CODE: unexpected layout of std::error_code" );
+};
 
-    template< class... Args >
-    void emplace_error( Args&&... args )
-    {
-        new( std11::addressof(m_error) ) error_type( std::forward<Args>(args)...);
-    }
+#endif // nsel_CONFIG_NICHE_ERROR_CODE
 
-    template< class U, class... Args >
-    void emplace_error( std::initializer_list<U> il, Args&&... args )
-    {
-        new( std11::addressof(m_error) ) error_type( il, std::forward<Args>(args)... );
-    }
+namespace detail {
 
-    void destruct_error()
-    {
-        m_error.~error_type();
-    }
+#if nsel_CONFIG_CONCEPTS
+// completes a requires-clause of nsel_REQUIRES_T():
+template< bool B >
+concept enabled = B;
+#endif
 
-    constexpr value_type const & value() const &
-    {
-        return m_value;
-    }
+#if nsel_P2505R >= 3
+template< typename T >
+struct is_expected : std::false_type {};
 
-    value_type & value() &
-    {
-        return m_value;
-    }
+template< typename T, typename E >
+struct is_expected< expected< T, E > > : std::true_type {};
+#endif // nsel_P2505R >= 3
 
-    constexpr value_type const && value() const &&
-    {
-        return std::move( m_value );
-    }
+/// storage traits: availability and triviality of the special members of storage_t.
 
-    nsel_constexpr14 value_type && value() &&
-    {
-        return std::move( m_value );
-    }
+template< typename T, typename E >
+struct is_copy_constructible_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std::is_copy_constructible<T>::value )
+    && std::is_copy_constructible<E>::value
+> {};
 
-    value_type const * value_ptr() const
-    {
-        return std11::addressof(m_value);
-    }
+template< typename T, typename E >
+struct is_move_constructible_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std::is_move_constructible<T>::value )
+    && std::is_move_constructible<E>::value
+> {};
 
-    value_type * value_ptr()
-    {
-        return std11::addressof(m_value);
-    }
+template< typename T, typename E >
+struct is_copy_assignable_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std::is_copy_assignable<T>::value )
+    && std::is_copy_assignable<E>::value
+    && is_copy_constructible_storage<T, E>::value
+> {};
 
-    error_type const & error() const &
-    {
-        return m_error;
-    }
+template< typename T, typename E >
+struct is_move_assignable_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std::is_move_assignable<T>::value )
+    && std::is_move_assignable<E>::value
+    && is_move_constructible_storage<T, E>::value
+> {};
 
-    error_type & error() &
-    {
-        return m_error;
-    }
+template< typename T, typename E >
+struct is_trivially_destructible_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std::is_trivially_destructible<T>::value )
+    && std::is_trivially_destructible<E>::value
+> {};
 
-    constexpr error_type const && error() const &&
-    {
-        return std::move( m_error );
-    }
+template< typename T, typename E >
+struct is_trivially_copy_constructible_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std11::is_trivially_copy_constructible<T>::value )
+    && std11::is_trivially_copy_constructible<E>::value
+    && is_trivially_destructible_storage<T, E>::value
+> {};
 
-    nsel_constexpr14 error_type && error() &&
-    {
-        return std::move( m_error );
-    }
+template< typename T, typename E >
+struct is_trivially_move_constructible_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std11::is_trivially_move_constructible<T>::value )
+    && std11::is_trivially_move_constructible<E>::value
+    && is_trivially_destructible_storage<T, E>::value
+> {};
+
+template< typename T, typename E >
+struct is_trivially_copy_assignable_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std11::is_trivially_copy_assignable<T>::value )
+    && std11::is_trivially_copy_assignable<E>::value
+    && is_trivially_copy_constructible_storage<T, E>::value
+> {};
+
+template< typename T, typename E >
+struct is_trivially_move_assignable_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || std11::is_trivially_move_assignable<T>::value )
+    && std11::is_trivially_move_assignable<E>::value
+    && is_trivially_move_constructible_storage<T, E>::value
+> {};
+
+template< typename T, typename E >
+struct is_nothrow_move_assignable_storage : std::integral_constant< bool,
+    ( std::is_void<T>::value || ( std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value ) )
+    && std::is_nothrow_move_constructible<E>::value
+    && std::is_nothrow_move_assignable<E>::value
+> {};
+
+/// discriminated union to hold value or 'error', trivial destructor.
+
+template< typename T, typename E, bool isTriviallyDestructible = is_trivially_destructible_storage<T, E>::value >
+class storage_t_union
+{
+public:
+    using value_type = T;
+    using error_type = E;
 
-    bool has_value() const
+    nsel_force_inline constexpr bool has_value() const
     {
         return m_has_value;
     }
@@ -714,6 +981,20 @@ public:
         m_has_value = v;
     }
 
+protected:
+    // no-op construction
+    storage_t_union() {}
+    ~storage_t_union() = default;
+
+    explicit storage_t_union( bool has_value )
+        : m_has_value( has_value )
+    {}
+
+    nsel_force_inline value_type       * value_address()       { return nsel_ADDRESSOF( m_value ); }
+    nsel_force_inline value_type const * value_address() const { return nsel_ADDRESSOF( m_value ); }
+    nsel_force_inline error_type       * error_address()       { return nsel_ADDRESSOF( m_error ); }
+    nsel_force_inline error_type const * error_address() const { return nsel_ADDRESSOF( m_error ); }
+
 private:
     union
     {
@@ -724,156 +1005,840 @@ private:
     bool m_has_value = false;
 };
 
+/// discriminated union to hold value or 'error', destroys current content.
+
 template< typename T, typename E >
-class storage_t_impl
+class storage_t_union< T, E, false >
 {
-    template< typename, typename > friend class nonstd::expected_lite::expected;
-
 public:
     using value_type = T;
     using error_type = E;
 
-    // no-op construction
-    storage_t_impl() {}
-    ~storage_t_impl() {}
-
-    explicit storage_t_impl( bool has_value )
-        : m_has_value( has_value )
-    {}
-
-    void construct_value()
+    nsel_force_inline constexpr bool has_value() const
     {
-        new( std11::addressof(m_value) ) value_type();
+        return m_has_value;
     }
 
-    void construct_value( value_type const & e )
+    void set_has_value( bool v )
     {
-        new( std11::addressof(m_value) ) value_type( e );
+        m_has_value = v;
     }
 
-    void construct_value( value_type && e )
+protected:
+    // no-op construction
+    storage_t_union() {}
+
+    ~storage_t_union()
     {
-        new( std11::addressof(m_value) ) value_type( std::move( e ) );
+        if ( m_has_value ) m_value.~value_type();
+        else               m_error.~error_type();
     }
 
-    template< class... Args >
+    explicit storage_t_union( bool has_value )
+        : m_has_value( has_value )
+    {}
+
+    nsel_force_inline value_type       * value_address()       { return nsel_ADDRESSOF( m_value ); }
+    nsel_force_inline value_type const * value_address() const { return nsel_ADDRESSOF( m_value ); }
+    nsel_force_inline error_type       * error_address()       { return nsel_ADDRESSOF( m_error ); }
+    nsel_force_inline error_type const * error_address() const { return nsel_ADDRESSOF( m_error ); }
+
+private:
+    union
+    {
+        value_type m_value;
+        error_type m_error;
+    };
+
+    bool m_has_value = false;
+};
+
+/// discriminated union to hold only 'error', trivial destructor.
+
+template< typename E >
+class storage_t_union< void, E, true >
+{
+public:
+    using value_type = void;
+    using error_type = E;
+
+    nsel_force_inline constexpr bool has_value() const
+    {
+        return m_has_value;
+    }
+
+    void set_has_value( bool v )
+    {
+        m_has_value = v;
+    }
+
+protected:
+    // no-op construction
+    storage_t_union() {}
+    ~storage_t_union() = default;
+
+    explicit storage_t_union( bool has_value )
+        : m_has_value( has_value )
+    {}
+
+    nsel_force_inline error_type       * error_address()       { return nsel_ADDRESSOF( m_error ); }
+    nsel_force_inline error_type const * error_address() const { return nsel_ADDRESSOF( m_error ); }
+
+private:
+    union
+    {
+        char m_dummy;
+        error_type m_error;
+    };
+
+    bool m_has_value = false;
+};
+
+/// discriminated union to hold only 'error', destroys current content.
+
+template< typename E >
+class storage_t_union< void, E, false >
+{
+public:
+    using value_type = void;
+    using error_type = E;
+
+    nsel_force_inline constexpr bool has_value() const
+    {
+        return m_has_value;
+    }
+
+    void set_has_value( bool v )
+    {
+        m_has_value = v;
+    }
+
+protected:
+    // no-op construction
+    storage_t_union() {}
+
+    ~storage_t_union()
+    {
+        if ( ! m_has_value ) m_error.~error_type();
+    }
+
+    explicit storage_t_union( bool has_value )
+        : m_has_value( has_value )
+    {}
+
+    nsel_force_inline error_type       * error_address()       { return nsel_ADDRESSOF( m_error ); }
+    nsel_force_inline error_type const * error_address() const { return nsel_ADDRESSOF( m_error ); }
+
+private:
+    union
+    {
+        char m_dummy;
+        error_type m_error;
+    };
+
+    bool m_has_value = false;
+};
+
+/// niche layout: place value and 'error' in the same bytes and encode the
+/// discriminant in the niche of either the value or the error (see niche_traits).
+
+enum niche_kind { niche_none, niche_in_value, niche_in_error };
+
+template< typename T > struct size_of  : std::integral_constant< std::size_t, sizeof(T) > {};
+template<>             struct size_of<void> : std::integral_constant< std::size_t, 0 > {};
+
+template< typename T > struct align_of : std::integral_constant< std::size_t, alignof(T) > {};
+template<>             struct align_of<void> : std::integral_constant< std::size_t, 1 > {};
+
+constexpr std::size_t max_of( std::size_t a, std::size_t b )
+{
+    return a < b ? b : a;
+}
+
+constexpr std::size_t align_up( std::size_t n, std::size_t a )
+{
+    return ( n + a - 1 ) / a * a;
+}
+
+// offset to place an object of size s and alignment a in [0, host) without overlapping
+// the niche bytes [no, no + ns), or host if there is no such place:
+
+constexpr std::size_t niche_place( std::size_t host, std::size_t no, std::size_t ns, std::size_t s, std::size_t a )
+{
+    return s <= no                          ? 0
+        : align_up( no + ns, a ) + s <= host ? align_up( no + ns, a )
+        : host;
+}
+
+// can Other be placed next to the niche of Host:
+
+template< typename Host, typename Other, bool hasNiche = niche_traits<Host>::has_niche >
+struct niche_fit
+{
+    static constexpr bool        fits   = false;
+    static constexpr std::size_t offset = 0;
+};
+
+template< typename Host, typename Other >
+struct niche_fit< Host, Other, true >
+{
+    static constexpr std::size_t offset = niche_place(
+        sizeof(Host), niche_traits<Host>::niche_offset, niche_traits<Host>::niche_size, size_of<Other>::value, align_of<Other>::value );
+
+    static constexpr bool fits = offset < sizeof(Host);
+};
+
+template< typename T, typename E >
+struct niche_layout
+{
+    using value_fit = niche_fit< T, E >;
+    using error_fit = niche_fit< E, T >;
+
+    static constexpr std::size_t align      = max_of( align_of<T>::value, alignof(E) );
+    static constexpr std::size_t union_size = align_up( max_of( size_of<T>::value, sizeof(E) ) + 1, align );
+
+    static constexpr niche_kind kind =
+          value_fit::fits && align_up( size_of<T>::value, align ) < union_size ? niche_in_value
+        : error_fit::fits && align_up( sizeof(E)        , align ) < union_size ? niche_in_error
+        : niche_none;
+
+    static constexpr std::size_t size         = kind == niche_in_value ? size_of<T>::value : sizeof(E);
+    static constexpr std::size_t value_offset = kind == niche_in_error ? error_fit::offset : 0;
+    static constexpr std::size_t error_offset = kind == niche_in_value ? value_fit::offset : 0;
+};
+
+// destruct value, no-op for void:
+
+template< typename T >
+void destruct( T * p )
+{
+    p->~T();
+}
+
+inline void destruct( void * ) {}
+
+/// niche layout, value and 'error' share the bytes, discriminant in niche of value or error.
+
+template< typename T, typename E, niche_kind kind >
+class storage_t_niche_layout;
+
+template< typename T, typename E >
+class storage_t_niche_layout< T, E, niche_in_value >
+{
+public:
+    using value_type = T;
+    using error_type = E;
+
+    nsel_force_inline bool has_value() const
+    {
+        return ! niche_traits<T>::is_niche( m_buffer );
+    }
+
+    void set_has_value( bool v )
+    {
+        if ( ! v ) niche_traits<T>::set_niche( m_buffer );
+    }
+
+protected:
+    using layout = niche_layout<T, E>;
+
+    // no-op construction
+    storage_t_niche_layout() {}
+
+    explicit storage_t_niche_layout( bool has_value )
+    {
+        set_has_value( has_value );
+    }
+
+    nsel_force_inline value_type       * value_address()       { return reinterpret_cast<value_type       *>( m_buffer ); }
+    nsel_force_inline value_type const * value_address() const { return reinterpret_cast<value_type const *>( m_buffer ); }
+    nsel_force_inline error_type       * error_address()       { return reinterpret_cast<error_type       *>( m_buffer + layout::error_offset ); }
+    nsel_force_inline error_type const * error_address() const { return reinterpret_cast<error_type const *>( m_buffer + layout::error_offset ); }
+
+private:
+    alignas( layout::align ) unsigned char m_buffer[ layout::size ];
+};
+
+template< typename T, typename E >
+class storage_t_niche_layout< T, E, niche_in_error >
+{
+public:
+    using value_type = T;
+    using error_type = E;
+
+    nsel_force_inline bool has_value() const
+    {
+        return niche_traits<E>::is_niche( m_buffer );
+    }
+
+    void set_has_value( bool v )
+    {
+        if ( v ) niche_traits<E>::set_niche( m_buffer );
+    }
+
+protected:
+    using layout = niche_layout<T, E>;
+
+    // no-op construction
+    storage_t_niche_layout() {}
+
+    explicit storage_t_niche_layout( bool has_value )
+    {
+        set_has_value( has_value );
+    }
+
+    nsel_force_inline value_type       * value_address()       { return reinterpret_cast<value_type       *>( m_buffer + layout::value_offset ); }
+    nsel_force_inline value_type const * value_address() const { return reinterpret_cast<value_type const *>( m_buffer + layout::value_offset ); }
+    nsel_force_inline error_type       * error_address()       { return reinterpret_cast<error_type       *>( m_buffer ); }
+    nsel_force_inline error_type const * error_address() const { return reinterpret_cast<error_type const *>( m_buffer ); }
+
+private:
+    alignas( layout::align ) unsigned char m_buffer[ layout::size ];
+};
+
+/// niche layout, trivial destructor.
+
+template< typename T, typename E, bool isTriviallyDestructible = is_trivially_destructible_storage<T, E>::value >
+class storage_t_niche : public storage_t_niche_layout< T, E, niche_layout<T, E>::kind >
+{
+protected:
+    // no-op construction
+    storage_t_niche() {}
+    ~storage_t_niche() = default;
+
+    explicit storage_t_niche( bool has_value )
+        : storage_t_niche_layout< T, E, niche_layout<T, E>::kind >( has_value )
+    {}
+};
+
+/// niche layout, destroys current content.
+
+template< typename T, typename E >
+class storage_t_niche< T, E, false > : public storage_t_niche_layout< T, E, niche_layout<T, E>::kind >
+{
+protected:
+    // no-op construction
+    storage_t_niche() {}
+
+    ~storage_t_niche()
+    {
+        if ( this->has_value() ) destruct( this->value_address() );
+        else                     this->error_address()->~E();
+    }
+
+    explicit storage_t_niche( bool has_value )
+        : storage_t_niche_layout< T, E, niche_layout<T, E>::kind >( has_value )
+    {}
+};
+
+/// storage base: niche layout if T or E provides a niche, discriminated union otherwise.
+
+template< typename T, typename E >
+using storage_t_base = typename std::conditional<
+    niche_layout<T, E>::kind != niche_none, storage_t_niche<T, E>, storage_t_union<T, E>
+>::type;
+
+/// replace the object at old by a New constructed from args, see reinit-expected in [expected.object.assign]:
+
+using reinit_direct    = std::integral_constant< int, 0 >;
+using reinit_temporary = std::integral_constant< int, 1 >;
+using reinit_backup    = std::integral_constant< int, 2 >;
+
+template< typename New, typename... Args >
+using reinit_strategy = std::integral_constant< int,
+    std::is_nothrow_constructible<New, Args&&...>::value ? reinit_direct::value
+    : std::is_nothrow_move_constructible<New>::value ? reinit_temporary::value : reinit_backup::value >;
+
+// construction does not throw:
+
+template< typename New, typename Old, typename... Args >
+void reinit( reinit_direct, New * newval, Old * oldval, Args &&... args )
+{
+    destruct( oldval );
+    new( newval ) New( std::forward<Args>( args )... );
+}
+
+// construct a temporary first, so that old is left intact if construction throws:
+
+template< typename New, typename Old, typename... Args >
+void reinit( reinit_temporary, New * newval, Old * oldval, Args &&... args )
+{
+    New tmp( std::forward<Args>( args )... );
+    destruct( oldval );
+    new( newval ) New( std::move( tmp ) );
+}
+
+// move old aside and restore it if construction throws:
+
+template< typename New, typename Old, typename... Args >
+void reinit( reinit_backup, New * newval, Old * oldval, Args &&... args )
+{
+    Old tmp( std::move( *oldval ) );
+    destruct( oldval );
+#if nsel_CONFIG_NO_EXCEPTIONS
+    new( newval ) New( std::forward<Args>( args )... );
+#else
+    try
+    {
+        new( newval ) New( std::forward<Args>( args )... );
+    }
+    catch (...)
+    {
+        new( oldval ) Old( std::move( tmp ) );
+        throw;
+    }
+#endif
+}
+
+// construct New from the value returned by f, in place via guaranteed copy elision (C++17):
+
+struct is_constructible_from_call_impl
+{
+    template< typename T, typename F, typename = decltype( T( std::declval<F>()() ) ) >
+    static std::true_type test( int /* unused */ );
+
+    template< typename, typename >
+    static std::false_type test(...);
+};
+
+template< typename T, typename F >
+struct is_constructible_from_call : decltype( is_constructible_from_call_impl::test<T, F>(0) ) {};
+
+template< typename T, typename F, bool = is_constructible_from_call<T, F>::value >
+struct is_nothrow_constructible_from_call : std::false_type {};
+
+template< typename T, typename F >
+struct is_nothrow_constructible_from_call< T, F, true > : std::integral_constant< bool, noexcept( T( std::declval<F>()() ) ) > {};
+
+template< typename New, typename F >
+using reinit_with_strategy = std::integral_constant< int,
+    is_nothrow_constructible_from_call<New, F>::value ? reinit_direct::value : reinit_backup::value >;
+
+template< typename New, typename Old, typename F >
+void reinit_with( reinit_direct, New * newval, Old * oldval, F && f )
+{
+    destruct( oldval );
+    new( newval ) New( std::forward<F>( f )() );
+}
+
+template< typename New, typename Old, typename F >
+void reinit_with( reinit_backup, New * newval, Old * oldval, F && f )
+{
+    Old tmp( std::move( *oldval ) );
+    destruct( oldval );
+#if nsel_CONFIG_NO_EXCEPTIONS
+    new( newval ) New( std::forward<F>( f )() );
+#else
+    try
+    {
+        new( newval ) New( std::forward<F>( f )() );
+    }
+    catch (...)
+    {
+        new( oldval ) Old( std::move( tmp ) );
+        throw;
+    }
+#endif
+}
+
+/// discriminated union to hold value or 'error'.
+
+template< typename T, typename E >
+class storage_t_noncopy_nonmove_impl : public storage_t_base<T, E>
+{
+    template< typename, typename > friend class nonstd::expected_lite::expected;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    using storage_t_base<T, E>::has_value;
+    using storage_t_base<T, E>::set_has_value;
+
+    // no-op construction
+    storage_t_noncopy_nonmove_impl() {}
+
+    explicit storage_t_noncopy_nonmove_impl( bool has_value )
+        : storage_t_base<T, E>( has_value )
+    {}
+
+    void construct_value()
+    {
+        new( this->value_address() ) value_type();
+    }
+
+    // void construct_value( value_type const & e )
+    // {
+    //     new( this->value_address() ) value_type( e );
+    // }
+
+    // void construct_value( value_type && e )
+    // {
+    //     new( this->value_address() ) value_type( std::move( e ) );
+    // }
+
+    template< class... Args >
     void emplace_value( Args&&... args )
     {
-        new( std11::addressof(m_value) ) value_type( std::forward<Args>(args)...);
+        new( this->value_address() ) value_type( std::forward<Args>(args)...);
     }
 
     template< class U, class... Args >
     void emplace_value( std::initializer_list<U> il, Args&&... args )
     {
-        new( std11::addressof(m_value) ) value_type( il, std::forward<Args>(args)... );
+        new( this->value_address() ) value_type( il, std::forward<Args>(args)... );
     }
 
     void destruct_value()
     {
-        m_value.~value_type();
+        this->value_address()->~value_type();
+    }
+
+    // void construct_error( error_type const & e )
+    // {
+    //     // new( this->error_address() ) error_type( e );
+    // }
+
+    // void construct_error( error_type && e )
+    // {
+    //     // new( this->error_address() ) error_type( std::move( e ) );
+    // }
+
+    template< class... Args >
+    void emplace_error( Args&&... args )
+    {
+        new( this->error_address() ) error_type( std::forward<Args>(args)...);
+    }
+
+    template< class U, class... Args >
+    void emplace_error( std::initializer_list<U> il, Args&&... args )
+    {
+        new( this->error_address() ) error_type( il, std::forward<Args>(args)... );
+    }
+
+    void destruct_error()
+    {
+        this->error_address()->~error_type();
+    }
+
+    // replace content by value or error, constructed in place, strong exception guarantee;
+    // the constraints of emplace() leave reinit_direct and reinit_temporary, which do not
+    // move the current content:
+
+    template< typename... Args >
+    void replace_value( Args &&... args )
+    {
+        if ( has_value() ) reinit( reinit_strategy<value_type, Args...>(), this->value_address(), this->value_address(), std::forward<Args>( args )... );
+        else             { reinit( reinit_strategy<value_type, Args...>(), this->value_address(), this->error_address(), std::forward<Args>( args )... ); set_has_value( true ); }
+    }
+
+    template< typename... Args >
+    void replace_error( Args &&... args )
+    {
+        if ( has_value() ) { reinit( reinit_strategy<error_type, Args...>(), this->error_address(), this->value_address(), std::forward<Args>( args )... ); set_has_value( false ); }
+        else                 reinit( reinit_strategy<error_type, Args...>(), this->error_address(), this->error_address(), std::forward<Args>( args )... );
+    }
+
+    template< typename F >
+    void replace_value_with( F && f )
+    {
+        if ( has_value() ) reinit_with( reinit_with_strategy<value_type, F>(), this->value_address(), this->value_address(), std::forward<F>( f ) );
+        else             { reinit_with( reinit_with_strategy<value_type, F>(), this->value_address(), this->error_address(), std::forward<F>( f ) ); set_has_value( true ); }
+    }
+
+    nsel_force_inline constexpr value_type const & value() const &
+    {
+        return *this->value_address();
+    }
+
+    nsel_force_inline value_type & value() &
+    {
+        return *this->value_address();
+    }
+
+    nsel_force_inline constexpr value_type const && value() const &&
+    {
+        return nsel_MOVE( *this->value_address() );
+    }
+
+    nsel_force_inline nsel_constexpr14 value_type && value() &&
+    {
+        return nsel_MOVE( *this->value_address() );
+    }
+
+    nsel_force_inline value_type const * value_ptr() const
+    {
+        return this->value_address();
+    }
+
+    nsel_force_inline value_type * value_ptr()
+    {
+        return this->value_address();
+    }
+
+    nsel_force_inline error_type const & error() const &
+    {
+        return *this->error_address();
+    }
+
+    nsel_force_inline error_type & error() &
+    {
+        return *this->error_address();
+    }
+
+    nsel_force_inline constexpr error_type const && error() const &&
+    {
+        return nsel_MOVE( *this->error_address() );
+    }
+
+    nsel_force_inline nsel_constexpr14 error_type && error() &&
+    {
+        return nsel_MOVE( *this->error_address() );
+    }
+};
+
+template< typename T, typename E >
+class storage_t_impl : public storage_t_base<T, E>
+{
+    template< typename, typename > friend class nonstd::expected_lite::expected;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    using storage_t_base<T, E>::has_value;
+    using storage_t_base<T, E>::set_has_value;
+
+    // no-op construction
+    storage_t_impl() {}
+
+    explicit storage_t_impl( bool has_value )
+        : storage_t_base<T, E>( has_value )
+    {}
+
+    void construct_value()
+    {
+        new( this->value_address() ) value_type();
+    }
+
+    void construct_value( value_type const & e )
+    {
+        new( this->value_address() ) value_type( e );
+    }
+
+    void construct_value( value_type && e )
+    {
+        new( this->value_address() ) value_type( std::move( e ) );
+    }
+
+    template< class... Args >
+    void emplace_value( Args&&... args )
+    {
+        new( this->value_address() ) value_type( std::forward<Args>(args)...);
+    }
+
+    template< class U, class... Args >
+    void emplace_value( std::initializer_list<U> il, Args&&... args )
+    {
+        new( this->value_address() ) value_type( il, std::forward<Args>(args)... );
+    }
+
+    void destruct_value()
+    {
+        this->value_address()->~value_type();
     }
 
     void construct_error( error_type const & e )
     {
-        new( std11::addressof(m_error) ) error_type( e );
+        new( this->error_address() ) error_type( e );
     }
 
     void construct_error( error_type && e )
     {
-        new( std11::addressof(m_error) ) error_type( std::move( e ) );
+        new( this->error_address() ) error_type( std::move( e ) );
     }
 
     template< class... Args >
     void emplace_error( Args&&... args )
     {
-        new( std11::addressof(m_error) ) error_type( std::forward<Args>(args)...);
+        new( this->error_address() ) error_type( std::forward<Args>(args)...);
     }
 
     template< class U, class... Args >
     void emplace_error( std::initializer_list<U> il, Args&&... args )
     {
-        new( std11::addressof(m_error) ) error_type( il, std::forward<Args>(args)... );
+        new( this->error_address() ) error_type( il, std::forward<Args>(args)... );
     }
 
     void destruct_error()
     {
-        m_error.~error_type();
+        this->error_address()->~error_type();
     }
 
-    constexpr value_type const & value() const &
+    // construct from other storage, which must hold the same state:
+
+    void copy_construct( storage_t_impl const & other )
     {
-        return m_value;
+        if ( other.has_value() ) construct_value( other.value() );
+        else               construct_error( other.error() );
     }
 
-    value_type & value() &
+    void move_construct( storage_t_impl && other )
     {
-        return m_value;
+        if ( other.has_value() ) construct_value( std::move( other.value() ) );
+        else               construct_error( std::move( other.error() ) );
     }
 
-    constexpr value_type const && value() const &&
+    // assign from other storage, in place if both hold the same state:
+
+    void copy_assign( storage_t_impl const & other )
     {
-        return std::move( m_value );
+        if      (   has_value() &&   other.has_value() ) { value() = other.value(); }
+        else if ( ! has_value() && ! other.has_value() ) { error() = other.error(); }
+        else if (   has_value()                        ) { reinit_error( other.error() ); }
+        else                                             { reinit_value( other.value() ); }
     }
 
-    nsel_constexpr14 value_type && value() &&
+    void move_assign( storage_t_impl && other )
     {
-        return std::move( m_value );
+        if      (   has_value() &&   other.has_value() ) { value() = std::move( other.value() ); }
+        else if ( ! has_value() && ! other.has_value() ) { error() = std::move( other.error() ); }
+        else if (   has_value()                        ) { reinit_error( std::move( other.error() ) ); }
+        else                                             { reinit_value( std::move( other.value() ) ); }
     }
 
-    value_type const * value_ptr() const
+    template< typename U >
+    void assign_value( U && v )
     {
-        return std11::addressof(m_value);
+        if ( has_value() ) value() = std::forward<U>( v );
+        else               reinit_value( std::forward<U>( v ) );
     }
 
-    value_type * value_ptr()
+    template< typename G >
+    void assign_error( G && e )
     {
-        return std11::addressof(m_value);
+        if ( has_value() ) reinit_error( std::forward<G>( e ) );
+        else               error() = std::forward<G>( e );
     }
 
-    error_type const & error() const &
+    // replace error by value and vice versa, strong exception guarantee:
+
+    template< typename... Args >
+    void reinit_value( Args &&... args )
     {
-        return m_error;
+        reinit( reinit_strategy<value_type, Args...>(), this->value_address(), this->error_address(), std::forward<Args>( args )... );
+        set_has_value( true );
     }
 
-    error_type & error() &
+    template< typename... Args >
+    void reinit_error( Args &&... args )
     {
-        return m_error;
+        reinit( reinit_strategy<error_type, Args...>(), this->error_address(), this->value_address(), std::forward<Args>( args )... );
+        set_has_value( false );
     }
 
-    constexpr error_type const && error() const &&
+    // replace content by value or error, constructed in place:
+
+    template< typename... Args >
+    void replace_value( Args &&... args )
     {
-        return std::move( m_error );
+        if ( has_value() ) reinit( reinit_strategy<value_type, Args...>(), this->value_address(), this->value_address(), std::forward<Args>( args )... );
+        else               reinit_value( std::forward<Args>( args )... );
     }
 
-    nsel_constexpr14 error_type && error() &&
+    template< typename... Args >
+    void replace_error( Args &&... args )
     {
-        return std::move( m_error );
+        if ( has_value() ) reinit_error( std::forward<Args>( args )... );
+        else               reinit( reinit_strategy<error_type, Args...>(), this->error_address(), this->error_address(), std::forward<Args>( args )... );
     }
 
-    bool has_value() const
+    template< typename F >
+    void replace_value_with( F && f )
     {
-        return m_has_value;
+        if ( has_value() )
+        {
+            reinit_with( reinit_with_strategy<value_type, F>(), this->value_address(), this->value_address(), std::forward<F>( f ) );
+        }
+        else
+        {
+            reinit_with( reinit_with_strategy<value_type, F>(), this->value_address(), this->error_address(), std::forward<F>( f ) );
+            set_has_value( true );
+        }
     }
 
-    void set_has_value( bool v )
+    void swap( storage_t_impl & other )
     {
-        m_has_value = v;
+        using std::swap;
+
+        if      (   has_value() &&   other.has_value() ) { swap( value(), other.value() ); }
+        else if ( ! has_value() && ! other.has_value() ) { swap( error(), other.error() ); }
+        else if (   has_value() && ! other.has_value() ) { error_type t( std::move( other.error() ) );
+                                                           other.destruct_error();
+                                                           other.construct_value( std::move( value() ) );
+                                                           destruct_value();
+                                                           construct_error( std::move( t ) );
+                                                           other.set_has_value( true );
+                                                           set_has_value( false );
+                                                         }
+        else if ( ! has_value() &&   other.has_value() ) { other.swap( *this ); }
     }
 
-private:
-    union
+    nsel_force_inline constexpr value_type const & value() const &
     {
-        value_type m_value;
-        error_type m_error;
-    };
+        return *this->value_address();
+    }
 
-    bool m_has_value = false;
+    nsel_force_inline value_type & value() &
+    {
+        return *this->value_address();
+    }
+
+    nsel_force_inline constexpr value_type const && value() const &&
+    {
+        return nsel_MOVE( *this->value_address() );
+    }
+
+    nsel_force_inline nsel_constexpr14 value_type && value() &&
+    {
+        return nsel_MOVE( *this->value_address() );
+    }
+
+    nsel_force_inline value_type const * value_ptr() const
+    {
+        return this->value_address();
+    }
+
+    nsel_force_inline value_type * value_ptr()
+    {
+        return this->value_address();
+    }
+
+    nsel_force_inline error_type const & error() const &
+    {
+        return *this->error_address();
+    }
+
+    nsel_force_inline error_type & error() &
+    {
+        return *this->error_address();
+    }
+
+    nsel_force_inline constexpr error_type const && error() const &&
+    {
+        return nsel_MOVE( *this->error_address() );
+    }
+
+    nsel_force_inline nsel_constexpr14 error_type && error() &&
+    {
+        return nsel_MOVE( *this->error_address() );
+    }
 };
 
 /// discriminated union to hold only 'error'.
 
 template< typename E >
-struct storage_t_impl< void, E >
+class storage_t_impl< void, E > : public storage_t_base<void, E>
 {
     template< typename, typename > friend class nonstd::expected_lite::expected;
 
@@ -881,240 +1846,371 @@ public:
     using value_type = void;
     using error_type = E;
 
+    using storage_t_base<void, E>::has_value;
+    using storage_t_base<void, E>::set_has_value;
+
     // no-op construction
     storage_t_impl() {}
-    ~storage_t_impl() {}
 
     explicit storage_t_impl( bool has_value )
-        : m_has_value( has_value )
+        : storage_t_base<void, E>( has_value )
     {}
 
-    void construct_error( error_type const & e )
+    void construct_error( error_type const & e )
+    {
+        new( this->error_address() ) error_type( e );
+    }
+
+    void construct_error( error_type && e )
+    {
+        new( this->error_address() ) error_type( std::move( e ) );
+    }
+
+    template< class... Args >
+    void emplace_error( Args&&... args )
+    {
+        new( this->error_address() ) error_type( std::forward<Args>(args)...);
+    }
+
+    template< class U, class... Args >
+    void emplace_error( std::initializer_list<U> il, Args&&... args )
+    {
+        new( this->error_address() ) error_type( il, std::forward<Args>(args)... );
+    }
+
+    void destruct_error()
+    {
+        this->error_address()->~error_type();
+    }
+
+    // construct from other storage, which must hold the same state:
+
+    void copy_construct( storage_t_impl const & other )
     {
-        new( std11::addressof(m_error) ) error_type( e );
+        if ( ! other.has_value() ) construct_error( other.error() );
     }
 
-    void construct_error( error_type && e )
+    void move_construct( storage_t_impl && other )
     {
-        new( std11::addressof(m_error) ) error_type( std::move( e ) );
+        if ( ! other.has_value() ) construct_error( std::move( other.error() ) );
     }
 
-    template< class... Args >
-    void emplace_error( Args&&... args )
+    // assign from other storage, in place if both hold an error:
+
+    void copy_assign( storage_t_impl const & other )
     {
-        new( std11::addressof(m_error) ) error_type( std::forward<Args>(args)...);
+        if      ( ! has_value() && ! other.has_value() ) { error() = other.error(); }
+        else if (   has_value() && ! other.has_value() ) { reinit_error( other.error() ); }
+        else if ( ! has_value() &&   other.has_value() ) { reinit_value(); }
     }
 
-    template< class U, class... Args >
-    void emplace_error( std::initializer_list<U> il, Args&&... args )
+    void move_assign( storage_t_impl && other )
     {
-        new( std11::addressof(m_error) ) error_type( il, std::forward<Args>(args)... );
+        if      ( ! has_value() && ! other.has_value() ) { error() = std::move( other.error() ); }
+        else if (   has_value() && ! other.has_value() ) { reinit_error( std::move( other.error() ) ); }
+        else if ( ! has_value() &&   other.has_value() ) { reinit_value(); }
     }
 
-    void destruct_error()
+    template< typename G >
+    void assign_error( G && e )
     {
-        m_error.~error_type();
+        if ( has_value() ) reinit_error( std::forward<G>( e ) );
+        else               error() = std::forward<G>( e );
     }
 
-    error_type const & error() const &
+    // replace error by value and vice versa, strong exception guarantee:
+
+    void reinit_value()
     {
-        return m_error;
+        destruct_error();
+        set_has_value( true );
     }
 
-    error_type & error() &
+    template< typename... Args >
+    void reinit_error( Args &&... args )
     {
-        return m_error;
+        emplace_error( std::forward<Args>( args )... );
+        set_has_value( false );
     }
 
-    constexpr error_type const && error() const &&
+    // replace content by value or error, constructed in place:
+
+    void replace_value()
     {
-        return std::move( m_error );
+        if ( ! has_value() ) reinit_value();
     }
 
-    nsel_constexpr14 error_type && error() &&
+    template< typename... Args >
+    void replace_error( Args &&... args )
     {
-        return std::move( m_error );
+        if ( has_value() ) reinit_error( std::forward<Args>( args )... );
+        else               reinit( reinit_strategy<error_type, Args...>(), this->error_address(), this->error_address(), std::forward<Args>( args )... );
     }
 
-    bool has_value() const
+    void swap( storage_t_impl & other )
     {
-        return m_has_value;
+        using std::swap;
+
+        if      ( ! has_value() && ! other.has_value() ) { swap( error(), other.error() ); }
+        else if (   has_value() && ! other.has_value() ) { construct_error( std::move( other.error() ) );
+                                                           other.destruct_error();
+                                                           other.set_has_value( true );
+                                                           set_has_value( false );
+                                                         }
+        else if ( ! has_value() &&   other.has_value() ) { other.swap( *this ); }
     }
 
-    void set_has_value( bool v )
+    nsel_force_inline error_type const & error() const &
     {
-        m_has_value = v;
+        return *this->error_address();
     }
 
-private:
-    union
+    nsel_force_inline error_type & error() &
     {
-        char m_dummy;
-        error_type m_error;
-    };
+        return *this->error_address();
+    }
 
-    bool m_has_value = false;
+    nsel_force_inline constexpr error_type const && error() const &&
+    {
+        return nsel_MOVE( *this->error_address() );
+    }
+
+    nsel_force_inline nsel_constexpr14 error_type && error() &&
+    {
+        return nsel_MOVE( *this->error_address() );
+    }
 };
 
-template< typename T, typename E, bool isConstructable, bool isMoveable >
-class storage_t
+/// copy construction: trivial if T and E are trivially copy-constructible, deleted if not copy-constructible.
+
+template< typename T, typename E, bool isDefaulted =
+    is_trivially_copy_constructible_storage<T, E>::value || !is_copy_constructible_storage<T, E>::value >
+class storage_t_copy_construct : public storage_t_impl<T, E>
 {
 public:
+    storage_t_copy_construct() = default;
+
+    explicit storage_t_copy_construct( bool has_value )
+        : storage_t_impl<T, E>( has_value )
+    {}
 };
 
 template< typename T, typename E >
-class storage_t<T, E, false, false> : public storage_t_noncopy_nonmove_impl<T, E>
+class storage_t_copy_construct<T, E, false> : public storage_t_impl<T, E>
 {
 public:
-    storage_t() = default;
-    ~storage_t() = default;
+    storage_t_copy_construct() = default;
 
-    explicit storage_t( bool has_value )
-        : storage_t_noncopy_nonmove_impl<T, E>( has_value )
+    explicit storage_t_copy_construct( bool has_value )
+        : storage_t_impl<T, E>( has_value )
     {}
 
-    storage_t( storage_t const & other ) = delete;
-    storage_t( storage_t &&      other ) = delete;
+    storage_t_copy_construct( storage_t_copy_construct const & other )
+        : storage_t_impl<T, E>( other.has_value() )
+    {
+        this->copy_construct( other );
+    }
+
+    storage_t_copy_construct( storage_t_copy_construct && ) = default;
+    storage_t_copy_construct & operator=( storage_t_copy_construct const & ) = default;
+    storage_t_copy_construct & operator=( storage_t_copy_construct && ) = default;
+};
+
+/// move construction: trivial if T and E are trivially move-constructible, deleted if not move-constructible.
+
+template< typename T, typename E, bool isDefaulted =
+    is_trivially_move_constructible_storage<T, E>::value || !is_move_constructible_storage<T, E>::value >
+class storage_t_move_construct : public storage_t_copy_construct<T, E>
+{
+public:
+    storage_t_move_construct() = default;
 
+    explicit storage_t_move_construct( bool has_value )
+        : storage_t_copy_construct<T, E>( has_value )
+    {}
 };
 
 template< typename T, typename E >
-class storage_t<T, E, true, true> : public storage_t_impl<T, E>
+class storage_t_move_construct<T, E, false> : public storage_t_copy_construct<T, E>
 {
 public:
-    storage_t() = default;
-    ~storage_t() = default;
+    storage_t_move_construct() = default;
 
-    explicit storage_t( bool has_value )
-        : storage_t_impl<T, E>( has_value )
+    explicit storage_t_move_construct( bool has_value )
+        : storage_t_copy_construct<T, E>( has_value )
     {}
 
-    storage_t( storage_t const & other )
-        : storage_t_impl<T, E>( other.has_value() )
-    {
-        if ( this->has_value() ) this->construct_value( other.value() );
-        else                     this->construct_error( other.error() );
-    }
+    storage_t_move_construct( storage_t_move_construct const & ) = default;
 
-    storage_t(storage_t && other )
-        : storage_t_impl<T, E>( other.has_value() )
+    storage_t_move_construct( storage_t_move_construct && other )
+        : storage_t_copy_construct<T, E>( other.has_value() )
     {
-        if ( this->has_value() ) this->construct_value( std::move( other.value() ) );
-        else                     this->construct_error( std::move( other.error() ) );
+        this->move_construct( std::move( other ) );
     }
+
+    storage_t_move_construct & operator=( storage_t_move_construct const & ) = default;
+    storage_t_move_construct & operator=( storage_t_move_construct && ) = default;
 };
 
-template< typename E >
-class storage_t<void, E, true, true> : public storage_t_impl<void, E>
+/// copy assignment: trivial if T and E are trivially copy-constructible, -assignable and -destructible,
+/// deleted if not copy-constructible and -assignable.
+
+template< typename T, typename E, bool isDefaulted =
+    is_trivially_copy_assignable_storage<T, E>::value || !is_copy_assignable_storage<T, E>::value >
+class storage_t_copy_assign : public storage_t_move_construct<T, E>
 {
 public:
-    storage_t() = default;
-    ~storage_t() = default;
+    storage_t_copy_assign() = default;
 
-    explicit storage_t( bool has_value )
-        : storage_t_impl<void, E>( has_value )
+    explicit storage_t_copy_assign( bool has_value )
+        : storage_t_move_construct<T, E>( has_value )
+    {}
+};
+
+template< typename T, typename E >
+class storage_t_copy_assign<T, E, false> : public storage_t_move_construct<T, E>
+{
+public:
+    storage_t_copy_assign() = default;
+
+    explicit storage_t_copy_assign( bool has_value )
+        : storage_t_move_construct<T, E>( has_value )
     {}
 
-    storage_t( storage_t const & other )
-        : storage_t_impl<void, E>( other.has_value() )
+    storage_t_copy_assign( storage_t_copy_assign const & ) = default;
+    storage_t_copy_assign( storage_t_copy_assign && ) = default;
+
+    storage_t_copy_assign & operator=( storage_t_copy_assign const & other )
     {
-        if ( this->has_value() ) ;
-        else                     this->construct_error( other.error() );
+        this->copy_assign( other );
+        return *this;
     }
 
-    storage_t(storage_t && other )
-        : storage_t_impl<void, E>( other.has_value() )
+    storage_t_copy_assign & operator=( storage_t_copy_assign && ) = default;
+};
+
+/// move assignment: trivial if T and E are trivially move-constructible, -assignable and -destructible,
+/// deleted if not move-constructible and -assignable.
+
+template< typename T, typename E, bool isDefaulted =
+    is_trivially_move_assignable_storage<T, E>::value || !is_move_assignable_storage<T, E>::value >
+class storage_t_move_assign : public storage_t_copy_assign<T, E>
+{
+public:
+    storage_t_move_assign() = default;
+
+    explicit storage_t_move_assign( bool has_value )
+        : storage_t_copy_assign<T, E>( has_value )
+    {}
+};
+
+template< typename T, typename E >
+class storage_t_move_assign<T, E, false> : public storage_t_copy_assign<T, E>
+{
+public:
+    storage_t_move_assign() = default;
+
+    explicit storage_t_move_assign( bool has_value )
+        : storage_t_copy_assign<T, E>( has_value )
+    {}
+
+    storage_t_move_assign( storage_t_move_assign const & ) = default;
+    storage_t_move_assign( storage_t_move_assign && ) = default;
+    storage_t_move_assign & operator=( storage_t_move_assign const & ) = default;
+
+    storage_t_move_assign & operator=( storage_t_move_assign && other ) noexcept
+    (
+        is_nothrow_move_assignable_storage<T, E>::value
+    )
     {
-        if ( this->has_value() ) ;
-        else                     this->construct_error( std::move( other.error() ) );
+        this->move_assign( std::move( other ) );
+        return *this;
     }
 };
 
+/// storage, copy and move availability:
+
+template< typename T, typename E, bool isConstructable, bool isMoveable >
+class storage_t
+{
+public:
+};
+
 template< typename T, typename E >
-class storage_t<T, E, true, false> : public storage_t_impl<T, E>
+class storage_t<T, E, false, false> : public storage_t_noncopy_nonmove_impl<T, E>
 {
 public:
     storage_t() = default;
     ~storage_t() = default;
 
     explicit storage_t( bool has_value )
-        : storage_t_impl<T, E>( has_value )
+        : storage_t_noncopy_nonmove_impl<T, E>( has_value )
     {}
 
-    storage_t( storage_t const & other )
-        : storage_t_impl<T, E>(other.has_value())
-    {
-        if ( this->has_value() ) this->construct_value( other.value() );
-        else                     this->construct_error( other.error() );
-    }
+    storage_t( storage_t const & other ) = delete;
+    storage_t( storage_t &&      other ) = delete;
 
-    storage_t( storage_t && other ) = delete;
 };
 
-template< typename E >
-class storage_t<void, E, true, false> : public storage_t_impl<void, E>
+template< typename T, typename E >
+class storage_t<T, E, true, true> : public storage_t_move_assign<T, E>
 {
 public:
     storage_t() = default;
     ~storage_t() = default;
 
     explicit storage_t( bool has_value )
-        : storage_t_impl<void, E>( has_value )
+        : storage_t_move_assign<T, E>( has_value )
     {}
 
-    storage_t( storage_t const & other )
-        : storage_t_impl<void, E>(other.has_value())
-    {
-        if ( this->has_value() ) ;
-        else                     this->construct_error( other.error() );
-    }
+    storage_t( storage_t const & other ) = default;
+    storage_t( storage_t &&      other ) = default;
 
-    storage_t( storage_t && other ) = delete;
+    storage_t & operator=( storage_t const & other ) = default;
+    storage_t & operator=( storage_t &&      other ) = default;
 };
 
 template< typename T, typename E >
-class storage_t<T, E, false, true> : public storage_t_impl<T, E>
+class storage_t<T, E, true, false> : public storage_t_move_assign<T, E>
 {
 public:
     storage_t() = default;
     ~storage_t() = default;
 
     explicit storage_t( bool has_value )
-        : storage_t_impl<T, E>( has_value )
+        : storage_t_move_assign<T, E>( has_value )
     {}
 
-    storage_t( storage_t const & other ) = delete;
+    storage_t( storage_t const & other ) = default;
+    storage_t( storage_t &&      other ) = delete;
 
-    storage_t( storage_t && other )
-        : storage_t_impl<T, E>( other.has_value() )
-    {
-        if ( this->has_value() ) this->construct_value( std::move( other.value() ) );
-        else                     this->construct_error( std::move( other.error() ) );
-    }
+    storage_t & operator=( storage_t const & other ) = default;
+    storage_t & operator=( storage_t &&      other ) = delete;
 };
 
-template< typename E >
-class storage_t<void, E, false, true> : public storage_t_impl<void, E>
+template< typename T, typename E >
+class storage_t<T, E, false, true> : public storage_t_move_assign<T, E>
 {
 public:
     storage_t() = default;
     ~storage_t() = default;
 
     explicit storage_t( bool has_value )
-        : storage_t_impl<void, E>( has_value )
+        : storage_t_move_assign<T, E>( has_value )
     {}
 
     storage_t( storage_t const & other ) = delete;
+    storage_t( storage_t &&      other ) = default;
 
-    storage_t( storage_t && other )
-        : storage_t_impl<void, E>( other.has_value() )
-    {
-        if ( this->has_value() ) ;
-        else                     this->construct_error( std::move( other.error() ) );
-    }
+    storage_t & operator=( storage_t const & other ) = delete;
+    storage_t & operator=( storage_t &&      other ) = default;
 };
 
 #if nsel_P2505R >= 3
+#if nsel_CONFIG_CONCEPTS
+// C++20 constexpr std::invoke
+using std::invoke;
+#else
 // C++11 invoke implementation
 template< typename >
 struct is_reference_wrapper : std::false_type {};
@@ -1238,6 +2334,7 @@ nsel_constexpr auto invoke( F && f, Args && ... args )
 {
     return std::forward< F >( f )( std::forward< Args >( args ) ... );
 }
+#endif // nsel_CONFIG_CONCEPTS
 
 template< typename F, typename ... Args >
 using invoke_result_nocvref_t = typename std20::remove_cvref< decltype( ::nonstd::expected_lite::detail::invoke( std::declval< F >(), std::declval< Args >()... ) ) >::type;
@@ -1247,7 +2344,7 @@ template< typename F, typename ... Args >
 using transform_invoke_result_t = typename std::remove_cv< decltype( ::nonstd::expected_lite::detail::invoke( std::declval< F >(), std::declval< Args >()... ) ) >::type;
 #else
 template< typename F, typename ... Args >
-using transform_invoke_result_t = invoke_result_nocvref_t
+using transform_invoke_result_t = invoke_result_nocvref_t< F, Args... >;
 #endif // nsel_P2505R >= 5
 
 template< typename T >
@@ -1257,14 +2354,10 @@ struct valid_expected_value_type : std::integral_constant< bool, std::is_destruc
 } // namespace detail
 
 /// x.x.5 Unexpected object type; unexpected_type; C++17 and later can also use aliased type unexpected.
+/// Note: with nsel_P0323R <= 2, E defaults to std::exception_ptr via the forward declaration.
 
-#if nsel_P0323R <= 2
-template< typename E = std::exception_ptr >
-class unexpected_type
-#else
 template< typename E >
 class unexpected_type
-#endif // nsel_P0323R
 {
 public:
     using error_type = E;
@@ -1515,6 +2608,16 @@ public:
     : m_error( std::make_exception_ptr( error ) )
     {}
 
+    std::exception_ptr const & error() const
+    {
+        return m_error;
+    }
+
+    std::exception_ptr & error()
+    {
+        return m_error;
+    }
+
     std::exception_ptr const & value() const
     {
         return m_error;
@@ -1532,6 +2635,8 @@ private:
 #endif // nsel_P0323R
 #endif // !nsel_CONFIG_NO_EXCEPTIONS
 
+#if nsel_CONFIG_RELATIONAL_OPERATORS
+
 /// x.x.4, Unexpected equality operators
 
 template< typename E1, typename E2 >
@@ -1573,6 +2678,7 @@ constexpr bool operator>=( unexpected_type<E> const & x, unexpected_type<E> cons
 }
 
 #endif // nsel_P0323R
+#endif // nsel_CONFIG_RELATIONAL_OPERATORS
 
 /// x.x.5 Specialized algorithms
 
@@ -1586,7 +2692,7 @@ void swap( unexpected_type<E> & x, unexpected_type<E> & y) noexcept ( noexcept (
     x.swap( y );
 }
 
-#if nsel_P0323R <= 2
+#if nsel_P0323R <= 2 && nsel_CONFIG_RELATIONAL_OPERATORS
 
 // unexpected: relational operators for std::exception_ptr:
 
@@ -1610,7 +2716,7 @@ inline constexpr bool operator>=( unexpected_type<std::exception_ptr> const & x,
     return ( x == y );
 }
 
-#endif // nsel_P0323R
+#endif // nsel_P0323R && nsel_CONFIG_RELATIONAL_OPERATORS
 
 // unexpected: traits
 
@@ -1648,7 +2754,7 @@ make_unexpected( nonstd_lite_in_place_t(E), Args &&... args ) -> unexpected_type
     return std::move( unexpected_type< typename std::decay<E>::type >( nonstd_lite_in_place(E), std::forward<Args>(args)...) );
 }
 
-#if nsel_P0323R <= 3
+#if nsel_P0323R <= 3 && nsel_CONFIG_CURRENT_EXCEPTION
 
 /*nsel_constexpr14*/ auto inline
 make_unexpected_from_current_exception() -> unexpected_type< std::exception_ptr >
@@ -1656,7 +2762,7 @@ make_unexpected_from_current_exception() -> unexpected_type< std::exception_ptr
     return unexpected_type< std::exception_ptr >( std::current_exception() );
 }
 
-#endif // nsel_P0323R
+#endif // nsel_P0323R && nsel_CONFIG_CURRENT_EXCEPTION
 
 /// x.x.6, x.x.7 expected access error
 
@@ -1731,6 +2837,64 @@ using in_place_unexpected_t = unexpect_t;
 nsel_inline17 constexpr unexpect_t unexpect{};
 nsel_inline17 constexpr unexpect_t in_place_unexpected{};
 
+/// contract violation handler, see nsel_CONFIG_CONTRACT_VIOLATION_HANDLER:
+
+using contract_violation_handler = void (*)( char const * condition, char const * file, int line );
+
+namespace detail {
+
+inline contract_violation_handler & registered_contract_violation_handler()
+{
+    static contract_violation_handler handler = nullptr;
+    return handler;
+}
+
+// report a violated precondition; out of line and cold, to keep the check in
+// the caller down to a compare and a branch:
+
+[[noreturn]] nsel_noinline nsel_cold inline void contract_violation( char const * condition, char const * file, int line )
+{
+#if   nsel_CONFIG_CONTRACT_VIOLATION_HANDLER == nsel_CONTRACT_VIOLATION_TRAP \
+    && ( nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_CLANG_VERSION )
+    (void) condition; (void) file; (void) line;
+    __builtin_trap();
+#else
+# if nsel_CONFIG_CONTRACT_VIOLATION_HANDLER == nsel_CONTRACT_VIOLATION_CALL_HANDLER
+    if ( contract_violation_handler handler = registered_contract_violation_handler() )
+    {
+        handler( condition, file, line );
+    }
+    else
+# endif
+    {
+        std::fprintf( stderr, "%s:%d: expected-lite: contract violation: %s\n", file, line, condition );
+    }
+    std::abort();
+#endif
+}
+
+} // namespace detail
+
+/// register handler for nsel_CONTRACT_VIOLATION_CALL_HANDLER, return previous handler;
+/// the handler must not return (it may throw), if it does, std::abort() is called:
+
+inline contract_violation_handler set_contract_violation_handler( contract_violation_handler handler ) noexcept
+{
+    contract_violation_handler previous = detail::registered_contract_violation_handler();
+    detail::registered_contract_violation_handler() = handler;
+    return previous;
+}
+
+// check precondition according to nsel_CONFIG_CONTRACT_VIOLATION_HANDLER, usable in C++11 constexpr functions:
+
+#if   nsel_CONFIG_CONTRACT_VIOLATION_HANDLER == nsel_CONTRACT_VIOLATION_ASSERT
+# define nsel_ASSERT( expr )  assert( expr )
+#elif nsel_CONFIG_CONTRACT_VIOLATION_HANDLER == nsel_CONTRACT_VIOLATION_IGNORE
+# define nsel_ASSERT( expr )  ( (void) 0 )
+#else
+# define nsel_ASSERT( expr )  ( nsel_LIKELY( expr ) ? (void) 0 : ::nonstd::expected_lite::detail::contract_violation( #expr, __FILE__, __LINE__ ) )
+#endif
+
 /// class error_traits
 
 #if nsel_CONFIG_NO_EXCEPTIONS
@@ -1747,7 +2911,7 @@ struct error_traits
 #if nsel_CONFIG_NO_EXCEPTIONS_SEH
         RaiseException( EXCEPTION_ACCESS_VIOLATION, EXCEPTION_NONCONTINUABLE, 0, NULL );
 #else
-        assert( false && detail::text("throw bad_expected_access<Error>{ e };") );
+        nsel_ASSERT( false && detail::text("throw bad_expected_access<Error>{ e };") );
 #endif
     }
 };
@@ -1760,7 +2924,7 @@ struct error_traits< std::exception_ptr >
 #if nsel_CONFIG_NO_EXCEPTIONS_SEH
         RaiseException( EXCEPTION_ACCESS_VIOLATION, EXCEPTION_NONCONTINUABLE, 0, NULL );
 #else
-        assert( false && detail::text("throw bad_expected_access<std::exception_ptr>{ e };") );
+        nsel_ASSERT( false && detail::text("throw bad_expected_access<std::exception_ptr>{ e };") );
 #endif
     }
 };
@@ -1773,7 +2937,7 @@ struct error_traits< std::error_code >
 #if nsel_CONFIG_NO_EXCEPTIONS_SEH
         RaiseException( EXCEPTION_ACCESS_VIOLATION, EXCEPTION_NONCONTINUABLE, 0, NULL );
 #else
-        assert( false && detail::text("throw std::system_error( e );") );
+        nsel_ASSERT( false && detail::text("throw std::system_error( e );") );
 #endif
     }
 };
@@ -1809,6 +2973,19 @@ struct error_traits< std::error_code >
 
 #endif // nsel_CONFIG_NO_EXCEPTIONS
 
+namespace detail {
+
+// report access to the value of an expected that holds an error; out of line
+// and cold, to keep the throw sequence out of the caller's hot path:
+
+template< typename E >
+nsel_noinline nsel_cold void report_bad_expected_access( E const & e )
+{
+    error_traits<E>::rethrow( e );
+}
+
+} // namespace detail
+
 #if nsel_P2505R >= 3
 namespace detail {
 
@@ -1836,14 +3013,10 @@ using expected_lite::unexpected_type;
 namespace expected_lite {
 
 /// class expected
+/// Note: with nsel_P0323R <= 2, E defaults to std::exception_ptr via the forward declaration.
 
-#if nsel_P0323R <= 2
-template< typename T, typename E = std::exception_ptr >
-class nsel_NODISCARD expected
-#else
 template< typename T, typename E >
 class nsel_NODISCARD expected
-#endif // nsel_P0323R
 {
 private:
     template< typename, typename > friend class expected;
@@ -1891,8 +3064,8 @@ public:
     nsel_constexpr14 explicit expected( expected<U, G> const & other )
     : contained( other.has_value() )
     {
-        if ( has_value() ) contained.construct_value( T{ other.contained.value() } );
-        else               contained.construct_error( E{ other.contained.error() } );
+        if ( other.has_value() ) contained.emplace_value( other.contained.value() );
+        else                     contained.emplace_error( other.contained.error() );
     }
 
     template< typename U, typename G
@@ -1913,8 +3086,8 @@ public:
     nsel_constexpr14 /*non-explicit*/ expected( expected<U, G> const & other )
     : contained( other.has_value() )
     {
-        if ( has_value() ) contained.construct_value( other.contained.value() );
-        else               contained.construct_error( other.contained.error() );
+        if ( other.has_value() ) contained.emplace_value( other.contained.value() );
+        else                     contained.emplace_error( other.contained.error() );
     }
 
     template< typename U, typename G
@@ -1935,8 +3108,8 @@ public:
     nsel_constexpr14 explicit expected( expected<U, G> && other )
     : contained( other.has_value() )
     {
-        if ( has_value() ) contained.construct_value( T{ std::move( other.contained.value() ) } );
-        else               contained.construct_error( E{ std::move( other.contained.error() ) } );
+        if ( other.has_value() ) contained.emplace_value( std::move( other.contained.value() ) );
+        else                     contained.emplace_error( std::move( other.contained.error() ) );
     }
 
     template< typename U, typename G
@@ -1957,8 +3130,8 @@ public:
     nsel_constexpr14 /*non-explicit*/ expected( expected<U, G> && other )
     : contained( other.has_value() )
     {
-        if ( has_value() ) contained.construct_value( std::move( other.contained.value() ) );
-        else               contained.construct_error( std::move( other.contained.error() ) );
+        if ( other.has_value() ) contained.emplace_value( std::move( other.contained.value() ) );
+        else                     contained.emplace_error( std::move( other.contained.error() ) );
     }
 
     template< typename U = T
@@ -1988,7 +3161,7 @@ public:
     )
     : contained( true )
     {
-        contained.construct_value( T{ std::forward<U>( value ) } );
+        contained.emplace_value( std::forward<U>( value ) );
     }
 
     template< typename U = T
@@ -2007,7 +3180,7 @@ public:
     )
     : contained( true )
     {
-        contained.construct_value( std::forward<U>( value ) );
+        contained.emplace_value( std::forward<U>( value ) );
     }
 
     // construct error:
@@ -2021,7 +3194,7 @@ public:
     nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> const & error )
     : contained( false )
     {
-        contained.construct_error( E{ error.error() } );
+        contained.emplace_error( error.error() );
     }
 
     template< typename G = E
@@ -2033,7 +3206,7 @@ public:
     nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> const & error )
     : contained( false )
     {
-        contained.construct_error( error.error() );
+        contained.emplace_error( error.error() );
     }
 
     template< typename G = E
@@ -2045,7 +3218,7 @@ public:
     nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> && error )
     : contained( false )
     {
-        contained.construct_error( E{ std::move( error.error() ) } );
+        contained.emplace_error( std::move( error.error() ) );
     }
 
     template< typename G = E
@@ -2057,7 +3230,7 @@ public:
     nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> && error )
     : contained( false )
     {
-        contained.construct_error( std::move( error.error() ) );
+        contained.emplace_error( std::move( error.error() ) );
     }
 
     // in-place construction, value
@@ -2110,46 +3283,29 @@ public:
 
     // x.x.4.2 destructor
 
-    // TODO: ~expected: triviality
-    // Effects: If T is not cv void and is_trivially_destructible_v<T> is false and bool(*this), calls val.~T(). If is_trivially_destructible_v<E> is false and !bool(*this), calls unexpect.~unexpected<E>().
-    // Remarks: If either T is cv void or is_trivially_destructible_v<T> is true, and is_trivially_destructible_v<E> is true, then this destructor shall be a trivial destructor.
+    // Trivial if T and E are trivially destructible, see detail::storage_t_union.
 
-    ~expected()
-    {
-        if ( has_value() ) contained.destruct_value();
-        else               contained.destruct_error();
-    }
+    ~expected() = default;
 
     // x.x.4.3 assignment
 
-    expected & operator=( expected const & other )
-    {
-        expected( other ).swap( *this );
-        return *this;
-    }
+    // Trivial if T and E are trivially copyable, see detail::storage_t_copy_assign, storage_t_move_assign.
+    // Otherwise assigns in place if both hold the same state, see detail::storage_t_impl::copy_assign().
 
-    expected & operator=( expected && other ) noexcept
-    (
-        std::is_nothrow_move_constructible<   T>::value
-        && std::is_nothrow_move_assignable<   T>::value
-        && std::is_nothrow_move_constructible<E>::value     // added for missing
-        && std::is_nothrow_move_assignable<   E>::value )   //   nothrow above
-    {
-        expected( std::move( other ) ).swap( *this );
-        return *this;
-    }
+    expected & operator=( expected const & other ) = default;
+    expected & operator=( expected &&      other ) = default;
 
     template< typename U
         nsel_REQUIRES_T(
             !std::is_same<expected<T,E>, typename std20::remove_cvref<U>::type>::value
-            && std17::conjunction<std::is_scalar<T>, std::is_same<T, std::decay<U>> >::value
+            && !std17::conjunction<std::is_scalar<T>, std::is_same<T, typename std::decay<U>::type> >::value
             && std::is_constructible<T ,U>::value
             && std::is_assignable<   T&,U>::value
             && std::is_nothrow_move_constructible<E>::value )
     >
     expected & operator=( U && value )
     {
-        expected( std::forward<U>( value ) ).swap( *this );
+        contained.assign_value( std::forward<U>( value ) );
         return *this;
     }
 
@@ -2162,7 +3318,7 @@ public:
     >
     expected & operator=( nonstd::unexpected_type<G> const & error )
     {
-        expected( unexpect, error.error() ).swap( *this );
+        contained.assign_error( error.error() );
         return *this;
     }
 
@@ -2175,30 +3331,80 @@ public:
     >
     expected & operator=( nonstd::unexpected_type<G> && error )
     {
-        expected( unexpect, std::move( error.error() ) ).swap( *this );
+        contained.assign_error( std::move( error.error() ) );
         return *this;
     }
 
+    // Destroys the current content and constructs the value in place. Besides the
+    // nothrow-constructible T of the standard, also accepts a nothrow-movable T (nonstd):
+    // then the value is constructed in a temporary first, strong exception guarantee.
+
     template< typename... Args
         nsel_REQUIRES_T(
             std::is_nothrow_constructible<T, Args&&...>::value
+            || ( std::is_constructible<T, Args&&...>::value && std::is_nothrow_move_constructible<T>::value )
         )
     >
     value_type & emplace( Args &&... args )
     {
-        expected( nonstd_lite_in_place(T), std::forward<Args>(args)... ).swap( *this );
-        return value();
+        contained.replace_value( std::forward<Args>(args)... );
+        return contained.value();
     }
 
     template< typename U, typename... Args
         nsel_REQUIRES_T(
             std::is_nothrow_constructible<T, std::initializer_list<U>&, Args&&...>::value
+            || ( std::is_constructible<T, std::initializer_list<U>&, Args&&...>::value && std::is_nothrow_move_constructible<T>::value )
         )
     >
     value_type & emplace( std::initializer_list<U> il, Args &&... args )
     {
-        expected( nonstd_lite_in_place(T), il, std::forward<Args>(args)... ).swap( *this );
-        return value();
+        contained.replace_value( il, std::forward<Args>(args)... );
+        return contained.value();
+    }
+
+    // Destroys the current content and constructs the value in place from the result
+    // of f() (nonstd). Since C++17 this works for a non-movable T via guaranteed copy
+    // elision. If f() may throw, the current content is moved aside and restored if
+    // it throws, which requires a nothrow-movable T and E.
+
+    template< typename F
+        nsel_REQUIRES_T(
+            detail::is_nothrow_constructible_from_call<T, F>::value
+            || ( detail::is_constructible_from_call<T, F>::value
+                && std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value )
+        )
+    >
+    value_type & emplace_with( F && f )
+    {
+        contained.replace_value_with( std::forward<F>( f ) );
+        return contained.value();
+    }
+
+    // Destroys the current content and constructs the error in place (nonstd).
+
+    template< typename... Args
+        nsel_REQUIRES_T(
+            std::is_nothrow_constructible<E, Args&&...>::value
+            || ( std::is_constructible<E, Args&&...>::value && std::is_nothrow_move_constructible<E>::value )
+        )
+    >
+    error_type & emplace_error( Args &&... args )
+    {
+        contained.replace_error( std::forward<Args>(args)... );
+        return contained.error();
+    }
+
+    template< typename U, typename... Args
+        nsel_REQUIRES_T(
+            std::is_nothrow_constructible<E, std::initializer_list<U>&, Args&&...>::value
+            || ( std::is_constructible<E, std::initializer_list<U>&, Args&&...>::value && std::is_nothrow_move_constructible<E>::value )
+        )
+    >
+    error_type & emplace_error( std::initializer_list<U> il, Args &&... args )
+    {
+        contained.replace_error( il, std::forward<Args>(args)... );
+        return contained.error();
     }
 
     // x.x.4.4 swap
@@ -2215,124 +3421,110 @@ public:
         std::is_nothrow_move_constructible<E>::value && std17::is_nothrow_swappable<E&>::value
     )
     {
-        using std::swap;
-
-        if      (   bool(*this) &&   bool(other) ) { swap( contained.value(), other.contained.value() ); }
-        else if ( ! bool(*this) && ! bool(other) ) { swap( contained.error(), other.contained.error() ); }
-        else if (   bool(*this) && ! bool(other) ) { error_type t( std::move( other.error() ) );
-                                                     other.contained.destruct_error();
-                                                     other.contained.construct_value( std::move( contained.value() ) );
-                                                     contained.destruct_value();
-                                                     contained.construct_error( std::move( t ) );
-                                                     bool has_value = contained.has_value();
-                                                     bool other_has_value = other.has_value();
-                                                     other.contained.set_has_value(has_value);
-                                                     contained.set_has_value(other_has_value);
-                                                   }
-        else if ( ! bool(*this) &&   bool(other) ) { other.swap( *this ); }
+        contained.swap( other.contained );
     }
 
     // x.x.4.5 observers
 
-    constexpr value_type const * operator ->() const
+    nsel_force_inline constexpr value_type const * operator ->() const
     {
-        return assert( has_value() ), contained.value_ptr();
+        return nsel_ASSERT( has_value() ), contained.value_ptr();
     }
 
-    value_type * operator ->()
+    nsel_force_inline value_type * operator ->()
     {
-        return assert( has_value() ), contained.value_ptr();
+        return nsel_ASSERT( has_value() ), contained.value_ptr();
     }
 
-    constexpr value_type const & operator *() const &
+    nsel_force_inline constexpr value_type const & operator *() const &
     {
-        return assert( has_value() ), contained.value();
+        return nsel_ASSERT( has_value() ), contained.value();
     }
 
-    value_type & operator *() &
+    nsel_force_inline value_type & operator *() &
     {
-        return assert( has_value() ), contained.value();
+        return nsel_ASSERT( has_value() ), contained.value();
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
 
-    constexpr value_type const && operator *() const &&
+    nsel_force_inline constexpr value_type const && operator *() const &&
     {
-        return std::move( ( assert( has_value() ), contained.value() ) );
+        return nsel_MOVE( ( nsel_ASSERT( has_value() ), contained.value() ) );
     }
 
-    nsel_constexpr14 value_type && operator *() &&
+    nsel_force_inline nsel_constexpr14 value_type && operator *() &&
     {
-        return std::move( ( assert( has_value() ), contained.value() ) );
+        return nsel_MOVE( ( nsel_ASSERT( has_value() ), contained.value() ) );
     }
 
 #endif
 
-    constexpr explicit operator bool() const noexcept
+    nsel_force_inline constexpr explicit operator bool() const noexcept
     {
         return has_value();
     }
 
-    constexpr bool has_value() const noexcept
+    nsel_force_inline constexpr bool has_value() const noexcept
     {
         return contained.has_value();
     }
 
     nsel_DISABLE_MSVC_WARNINGS( 4702 )  // warning C4702: unreachable code, see issue 65.
 
-    constexpr value_type const & value() const &
+    nsel_force_inline constexpr value_type const & value() const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( contained.value() )
-            : ( error_traits<error_type>::rethrow( contained.error() ), contained.value() );
+            : ( detail::report_bad_expected_access( contained.error() ), contained.value() );
     }
 
-    value_type & value() &
+    nsel_force_inline value_type & value() &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( contained.value() )
-            : ( error_traits<error_type>::rethrow( contained.error() ), contained.value() );
+            : ( detail::report_bad_expected_access( contained.error() ), contained.value() );
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
 
-    constexpr value_type const && value() const &&
+    nsel_force_inline constexpr value_type const && value() const &&
     {
-        return std::move( has_value()
+        return nsel_MOVE( nsel_LIKELY( has_value() )
             ? ( contained.value() )
-            : ( error_traits<error_type>::rethrow( contained.error() ), contained.value() ) );
+            : ( detail::report_bad_expected_access( contained.error() ), contained.value() ) );
     }
 
-    nsel_constexpr14 value_type && value() &&
+    nsel_force_inline nsel_constexpr14 value_type && value() &&
     {
-        return std::move( has_value()
+        return nsel_MOVE( nsel_LIKELY( has_value() )
             ? ( contained.value() )
-            : ( error_traits<error_type>::rethrow( contained.error() ), contained.value() ) );
+            : ( detail::report_bad_expected_access( contained.error() ), contained.value() ) );
     }
 
 #endif
     nsel_RESTORE_MSVC_WARNINGS()
 
-    constexpr error_type const & error() const &
+    nsel_force_inline constexpr error_type const & error() const &
     {
-        return assert( ! has_value() ), contained.error();
+        return nsel_ASSERT( ! has_value() ), contained.error();
     }
 
-    error_type & error() &
+    nsel_force_inline error_type & error() &
     {
-        return assert( ! has_value() ), contained.error();
+        return nsel_ASSERT( ! has_value() ), contained.error();
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
 
-    constexpr error_type const && error() const &&
+    nsel_force_inline constexpr error_type const && error() const &&
     {
-        return std::move( ( assert( ! has_value() ), contained.error() ) );
+        return nsel_MOVE( ( nsel_ASSERT( ! has_value() ), contained.error() ) );
     }
 
-    error_type && error() &&
+    nsel_force_inline error_type && error() &&
     {
-        return std::move( ( assert( ! has_value() ), contained.error() ) );
+        return nsel_MOVE( ( nsel_ASSERT( ! has_value() ), contained.error() ) );
     }
 
 #endif
@@ -2357,7 +3549,7 @@ public:
     >
     value_type value_or( U && v ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? contained.value()
             : static_cast<T>( std::forward<U>( v ) );
     }
@@ -2370,7 +3562,7 @@ public:
     >
     value_type value_or( U && v ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? std::move( contained.value() )
             : static_cast<T>( std::forward<U>( v ) );
     }
@@ -2384,7 +3576,7 @@ public:
     >
     nsel_constexpr error_type error_or( G && e ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? static_cast< E >( std::forward< G >( e ) )
             : contained.error();
     }
@@ -2397,7 +3589,7 @@ public:
     >
     nsel_constexpr14 error_type error_or( G && e ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? static_cast< E >( std::forward< G >( e ) )
             : std::move( contained.error() );
     }
@@ -2414,7 +3606,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F, value_type & > and_then( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, value_type & >( detail::invoke( std::forward< F >( f ), value() ) )
             : detail::invoke_result_nocvref_t< F, value_type & >( unexpect, error() );
     }
@@ -2428,7 +3620,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F, const value_type & > and_then( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, const value_type & >( detail::invoke( std::forward< F >( f ), value() ) )
             : detail::invoke_result_nocvref_t< F, const value_type & >( unexpect, error() );
     }
@@ -2443,7 +3635,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F, value_type && > and_then( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, value_type && >( detail::invoke( std::forward< F >( f ), std::move( value() ) ) )
             : detail::invoke_result_nocvref_t< F, value_type && >( unexpect, std::move( error() ) );
     }
@@ -2457,7 +3649,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F, const value_type && > and_then( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, const value_type && >( detail::invoke( std::forward< F >( f ), std::move( value() ) ) )
             : detail::invoke_result_nocvref_t< F, const value_type && >( unexpect, std::move( error() ) );
     }
@@ -2472,7 +3664,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F, error_type & > or_else( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, error_type & >( value() )
             : detail::invoke_result_nocvref_t< F, error_type & >( detail::invoke( std::forward< F >( f ), error() ) );
     }
@@ -2486,7 +3678,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F, const error_type & > or_else( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, const error_type & >( value() )
             : detail::invoke_result_nocvref_t< F, const error_type & >( detail::invoke( std::forward< F >( f ), error() ) );
     }
@@ -2501,7 +3693,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F, error_type && > or_else( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, error_type && >( std::move( value() ) )
             : detail::invoke_result_nocvref_t< F, error_type && >( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
@@ -2515,7 +3707,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F, const error_type && > or_else( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, const error_type && >( std::move( value() ) )
             : detail::invoke_result_nocvref_t< F, const error_type && >( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
@@ -2530,9 +3722,9 @@ public:
     >
     nsel_constexpr14 expected< detail::transform_invoke_result_t< F, value_type & >, error_type > transform( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F, value_type & >, error_type >( detail::invoke( std::forward< F >( f ), **this ) )
-            : make_unexpected( error() );
+            : expected< detail::transform_invoke_result_t< F, value_type & >, error_type >( unexpect, error() );
     }
 
     template<typename F
@@ -2543,9 +3735,9 @@ public:
     >
     nsel_constexpr14 expected< void, error_type > transform( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ), **this ), expected< void, error_type >() )
-            : make_unexpected( error() );
+            : expected< void, error_type >( unexpect, error() );
     }
 
     template<typename F
@@ -2557,9 +3749,9 @@ public:
     >
     nsel_constexpr expected< detail::transform_invoke_result_t< F, const value_type & >, error_type > transform( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F, const value_type & >, error_type >( detail::invoke( std::forward< F >( f ), **this ) )
-            : make_unexpected( error() );
+            : expected< detail::transform_invoke_result_t< F, const value_type & >, error_type >( unexpect, error() );
     }
 
     template<typename F
@@ -2570,9 +3762,9 @@ public:
     >
     nsel_constexpr expected< void, error_type > transform( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ), **this ), expected< void, error_type >() )
-            : make_unexpected( error() );
+            : expected< void, error_type >( unexpect, error() );
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
@@ -2585,9 +3777,9 @@ public:
     >
     nsel_constexpr14 expected< detail::transform_invoke_result_t< F, value_type && >, error_type > transform( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F, value_type && >, error_type >( detail::invoke( std::forward< F >( f ), std::move( **this ) ) )
-            : make_unexpected( std::move( error() ) );
+            : expected< detail::transform_invoke_result_t< F, value_type && >, error_type >( unexpect, std::move( error() ) );
     }
 
     template<typename F
@@ -2598,9 +3790,9 @@ public:
     >
     nsel_constexpr14 expected< void, error_type > transform( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ), **this ), expected< void, error_type >() )
-            : make_unexpected( std::move( error() ) );
+            : expected< void, error_type >( unexpect, std::move( error() ) );
     }
 
     template<typename F
@@ -2612,9 +3804,9 @@ public:
     >
     nsel_constexpr expected< detail::transform_invoke_result_t< F, const value_type && >, error_type > transform( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F, const value_type && >, error_type >( detail::invoke( std::forward< F >( f ), std::move( **this ) ) )
-            : make_unexpected( std::move( error() ) );
+            : expected< detail::transform_invoke_result_t< F, const value_type && >, error_type >( unexpect, std::move( error() ) );
     }
 
     template<typename F
@@ -2625,9 +3817,9 @@ public:
     >
     nsel_constexpr expected< void, error_type > transform( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ), **this ), expected< void, error_type >() )
-            : make_unexpected( std::move( error() ) );
+            : expected< void, error_type >( unexpect, std::move( error() ) );
     }
 #endif
 
@@ -2639,9 +3831,9 @@ public:
     >
     nsel_constexpr14 expected< value_type, detail::transform_invoke_result_t< F, error_type & > > transform_error( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< value_type, detail::transform_invoke_result_t< F, error_type & > >( in_place, **this )
-            : make_unexpected( detail::invoke( std::forward< F >( f ), error() ) );
+            : expected< value_type, detail::transform_invoke_result_t< F, error_type & > >( unexpect, detail::invoke( std::forward< F >( f ), error() ) );
     }
 
     template<typename F
@@ -2652,9 +3844,9 @@ public:
     >
     nsel_constexpr expected< value_type, detail::transform_invoke_result_t< F, const error_type & > > transform_error( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< value_type, detail::transform_invoke_result_t< F, const error_type & > >( in_place, **this )
-            : make_unexpected( detail::invoke( std::forward< F >( f ), error() ) );
+            : expected< value_type, detail::transform_invoke_result_t< F, const error_type & > >( unexpect, detail::invoke( std::forward< F >( f ), error() ) );
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
@@ -2666,9 +3858,9 @@ public:
     >
     nsel_constexpr14 expected< value_type, detail::transform_invoke_result_t< F, error_type && > > transform_error( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< value_type, detail::transform_invoke_result_t< F, error_type && > >( in_place, std::move( **this ) )
-            : make_unexpected( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
+            : expected< value_type, detail::transform_invoke_result_t< F, error_type && > >( unexpect, detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
 
     template<typename F
@@ -2679,9 +3871,9 @@ public:
     >
     nsel_constexpr expected< value_type, detail::transform_invoke_result_t< F, const error_type && > > transform_error( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< value_type, detail::transform_invoke_result_t< F, const error_type && > >( in_place, std::move( **this ) )
-            : make_unexpected( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
+            : expected< value_type, detail::transform_invoke_result_t< F, const error_type && > >( unexpect, detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
 #endif
 #endif // nsel_P2505R >= 3
@@ -2761,7 +3953,7 @@ public:
     nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> const & error )
         : contained( false )
     {
-        contained.construct_error( E{ error.error() } );
+        contained.emplace_error( error.error() );
     }
 
     template< typename G = E
@@ -2772,7 +3964,7 @@ public:
     nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> const & error )
         : contained( false )
     {
-        contained.construct_error( error.error() );
+        contained.emplace_error( error.error() );
     }
 
     template< typename G = E
@@ -2783,7 +3975,7 @@ public:
     nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> && error )
         : contained( false )
     {
-        contained.construct_error( E{ std::move( error.error() ) } );
+        contained.emplace_error( std::move( error.error() ) );
     }
 
     template< typename G = E
@@ -2794,7 +3986,7 @@ public:
     nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> && error )
         : contained( false )
     {
-        contained.construct_error( std::move( error.error() ) );
+        contained.emplace_error( std::move( error.error() ) );
     }
 
     template< typename... Args
@@ -2821,34 +4013,68 @@ public:
 
     // destructor
 
-    ~expected()
-    {
-        if ( ! has_value() )
-        {
-            contained.destruct_error();
-        }
-    }
+    // Trivial if E is trivially destructible, see detail::storage_t_union.
+
+    ~expected() = default;
 
     // x.x.4.3 assignment
 
-    expected & operator=( expected const & other )
+    expected & operator=( expected const & other ) = default;
+    expected & operator=( expected &&      other ) = default;
+
+    template< typename G = E
+        nsel_REQUIRES_T(
+            std::is_constructible<E, G const&>::value
+            && std::is_copy_assignable<G>::value
+        )
+    >
+    expected & operator=( nonstd::unexpected_type<G> const & error )
     {
-        expected( other ).swap( *this );
+        contained.assign_error( error.error() );
         return *this;
     }
 
-    expected & operator=( expected && other ) noexcept
-    (
-        std::is_nothrow_move_assignable<E>::value &&
-        std::is_nothrow_move_constructible<E>::value )
+    template< typename G = E
+        nsel_REQUIRES_T(
+            std::is_constructible<E, G&&>::value
+            && std::is_move_assignable<G>::value
+        )
+    >
+    expected & operator=( nonstd::unexpected_type<G> && error )
     {
-        expected( std::move( other ) ).swap( *this );
+        contained.assign_error( std::move( error.error() ) );
         return *this;
     }
 
-    void emplace()
+    void emplace()
+    {
+        contained.replace_value();
+    }
+
+    // Destroys the current content and constructs the error in place (nonstd).
+
+    template< typename... Args
+        nsel_REQUIRES_T(
+            std::is_nothrow_constructible<E, Args&&...>::value
+            || ( std::is_constructible<E, Args&&...>::value && std::is_nothrow_move_constructible<E>::value )
+        )
+    >
+    error_type & emplace_error( Args &&... args )
+    {
+        contained.replace_error( std::forward<Args>(args)... );
+        return contained.error();
+    }
+
+    template< typename U, typename... Args
+        nsel_REQUIRES_T(
+            std::is_nothrow_constructible<E, std::initializer_list<U>&, Args&&...>::value
+            || ( std::is_constructible<E, std::initializer_list<U>&, Args&&...>::value && std::is_nothrow_move_constructible<E>::value )
+        )
+    >
+    error_type & emplace_error( std::initializer_list<U> il, Args &&... args )
     {
-        expected().swap( *this );
+        contained.replace_error( il, std::forward<Args>(args)... );
+        return contained.error();
     }
 
     // x.x.4.4 swap
@@ -2863,58 +4089,49 @@ public:
         std::is_nothrow_move_constructible<E>::value && std17::is_nothrow_swappable<E&>::value
     )
     {
-        using std::swap;
-
-        if      ( ! bool(*this) && ! bool(other) ) { swap( contained.error(), other.contained.error() ); }
-        else if (   bool(*this) && ! bool(other) ) { contained.construct_error( std::move( other.error() ) );
-                                                     bool has_value = contained.has_value();
-                                                     bool other_has_value = other.has_value();
-                                                     other.contained.set_has_value(has_value);
-                                                     contained.set_has_value(other_has_value);
-                                                     }
-        else if ( ! bool(*this) &&   bool(other) ) { other.swap( *this ); }
+        contained.swap( other.contained );
     }
 
     // x.x.4.5 observers
 
-    constexpr explicit operator bool() const noexcept
+    nsel_force_inline constexpr explicit operator bool() const noexcept
     {
         return has_value();
     }
 
-    constexpr bool has_value() const noexcept
+    nsel_force_inline constexpr bool has_value() const noexcept
     {
         return contained.has_value();
     }
 
-    void value() const
+    nsel_force_inline void value() const
     {
-        if ( ! has_value() )
+        if ( nsel_UNLIKELY( ! has_value() ) )
         {
-            error_traits<error_type>::rethrow( contained.error() );
+            detail::report_bad_expected_access( contained.error() );
         }
     }
 
-    constexpr error_type const & error() const &
+    nsel_force_inline constexpr error_type const & error() const &
     {
-        return assert( ! has_value() ), contained.error();
+        return nsel_ASSERT( ! has_value() ), contained.error();
     }
 
-    error_type & error() &
+    nsel_force_inline error_type & error() &
     {
-        return assert( ! has_value() ), contained.error();
+        return nsel_ASSERT( ! has_value() ), contained.error();
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
 
-    constexpr error_type const && error() const &&
+    nsel_force_inline constexpr error_type const && error() const &&
     {
-        return std::move( ( assert( ! has_value() ), contained.error() ) );
+        return nsel_MOVE( ( nsel_ASSERT( ! has_value() ), contained.error() ) );
     }
 
-    error_type && error() &&
+    nsel_force_inline error_type && error() &&
     {
-        return std::move( ( assert( ! has_value() ), contained.error() ) );
+        return nsel_MOVE( ( nsel_ASSERT( ! has_value() ), contained.error() ) );
     }
 
 #endif
@@ -2940,7 +4157,7 @@ public:
     >
     nsel_constexpr error_type error_or( G && e ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? static_cast< E >( std::forward< G >( e ) )
             : contained.error();
     }
@@ -2953,7 +4170,7 @@ public:
     >
     nsel_constexpr14 error_type error_or( G && e ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? static_cast< E >( std::forward< G >( e ) )
             : std::move( contained.error() );
     }
@@ -2970,7 +4187,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F > and_then( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F >( detail::invoke( std::forward< F >( f ) ) )
             : detail::invoke_result_nocvref_t< F >( unexpect, error() );
     }
@@ -2984,7 +4201,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F > and_then( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F >( detail::invoke( std::forward< F >( f ) ) )
             : detail::invoke_result_nocvref_t< F >( unexpect, error() );
     }
@@ -2999,7 +4216,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F > and_then( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F >( detail::invoke( std::forward< F >( f ) ) )
             : detail::invoke_result_nocvref_t< F >( unexpect, std::move( error() ) );
     }
@@ -3013,7 +4230,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F > and_then( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F >( detail::invoke( std::forward< F >( f ) ) )
             : detail::invoke_result_nocvref_t< F >( unexpect, std::move( error() ) );
     }
@@ -3027,7 +4244,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F, error_type & > or_else( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, error_type & >()
             : detail::invoke_result_nocvref_t< F, error_type & >( detail::invoke( std::forward< F >( f ), error() ) );
     }
@@ -3040,7 +4257,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F, const error_type & > or_else( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, const error_type & >()
             : detail::invoke_result_nocvref_t< F, const error_type & >( detail::invoke( std::forward< F >( f ), error() ) );
     }
@@ -3054,7 +4271,7 @@ public:
     >
     nsel_constexpr14 detail::invoke_result_nocvref_t< F, error_type && > or_else( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, error_type && >()
             : detail::invoke_result_nocvref_t< F, error_type && >( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
@@ -3067,7 +4284,7 @@ public:
     >
     nsel_constexpr detail::invoke_result_nocvref_t< F, const error_type && > or_else( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? detail::invoke_result_nocvref_t< F, const error_type && >()
             : detail::invoke_result_nocvref_t< F, const error_type && >( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
@@ -3081,9 +4298,9 @@ public:
     >
     nsel_constexpr14 expected< detail::transform_invoke_result_t< F >, error_type > transform( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F >, error_type >( detail::invoke( std::forward< F >( f ) ) )
-            : make_unexpected( error() );
+            : expected< detail::transform_invoke_result_t< F >, error_type >( unexpect, error() );
     }
 
     template<typename F
@@ -3094,9 +4311,9 @@ public:
     >
     nsel_constexpr14 expected< void, error_type > transform( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ) ), expected< void, error_type >() )
-            : make_unexpected( error() );
+            : expected< void, error_type >( unexpect, error() );
     }
 
     template<typename F
@@ -3107,9 +4324,9 @@ public:
     >
     nsel_constexpr expected< detail::transform_invoke_result_t< F >, error_type > transform( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F >, error_type >( detail::invoke( std::forward< F >( f ) ) )
-            : make_unexpected( error() );
+            : expected< detail::transform_invoke_result_t< F >, error_type >( unexpect, error() );
     }
 
     template<typename F
@@ -3120,9 +4337,9 @@ public:
     >
     nsel_constexpr expected< void, error_type > transform( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ) ), expected< void, error_type >() )
-            : make_unexpected( error() );
+            : expected< void, error_type >( unexpect, error() );
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
@@ -3134,9 +4351,9 @@ public:
     >
     nsel_constexpr14 expected< detail::transform_invoke_result_t< F >, error_type > transform( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F >, error_type >( detail::invoke( std::forward< F >( f ) ) )
-            : make_unexpected( error() );
+            : expected< detail::transform_invoke_result_t< F >, error_type >( unexpect, std::move( error() ) );
     }
 
     template<typename F
@@ -3147,9 +4364,9 @@ public:
     >
     nsel_constexpr14 expected< void, error_type > transform( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ) ), expected< void, error_type >() )
-            : make_unexpected( error() );
+            : expected< void, error_type >( unexpect, std::move( error() ) );
     }
 
     template<typename F
@@ -3160,9 +4377,9 @@ public:
     >
     nsel_constexpr expected< detail::transform_invoke_result_t< F >, error_type > transform( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< detail::transform_invoke_result_t< F >, error_type >( detail::invoke( std::forward< F >( f ) ) )
-            : make_unexpected( error() );
+            : expected< detail::transform_invoke_result_t< F >, error_type >( unexpect, std::move( error() ) );
     }
 
     template<typename F
@@ -3173,9 +4390,9 @@ public:
     >
     nsel_constexpr expected< void, error_type > transform( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? ( detail::invoke( std::forward< F >( f ) ), expected< void, error_type >() )
-            : make_unexpected( error() );
+            : expected< void, error_type >( unexpect, std::move( error() ) );
     }
 #endif
 
@@ -3186,9 +4403,9 @@ public:
     >
     nsel_constexpr14 expected< void, detail::transform_invoke_result_t< F, error_type & > > transform_error( F && f ) &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< void, detail::transform_invoke_result_t< F, error_type & > >()
-            : make_unexpected( detail::invoke( std::forward< F >( f ), error() ) );
+            : expected< void, detail::transform_invoke_result_t< F, error_type & > >( unexpect, detail::invoke( std::forward< F >( f ), error() ) );
     }
 
     template<typename F
@@ -3198,9 +4415,9 @@ public:
     >
     nsel_constexpr expected< void, detail::transform_invoke_result_t< F, const error_type & > > transform_error( F && f ) const &
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< void, detail::transform_invoke_result_t< F, const error_type & > >()
-            : make_unexpected( detail::invoke( std::forward< F >( f ), error() ) );
+            : expected< void, detail::transform_invoke_result_t< F, const error_type & > >( unexpect, detail::invoke( std::forward< F >( f ), error() ) );
     }
 
 #if !nsel_COMPILER_GNUC_VERSION || nsel_COMPILER_GNUC_VERSION >= 490
@@ -3211,9 +4428,9 @@ public:
     >
     nsel_constexpr14 expected< void, detail::transform_invoke_result_t< F, error_type && > > transform_error( F && f ) &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< void, detail::transform_invoke_result_t< F, error_type && > >()
-            : make_unexpected( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
+            : expected< void, detail::transform_invoke_result_t< F, error_type && > >( unexpect, detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
 
     template<typename F
@@ -3223,9 +4440,9 @@ public:
     >
     nsel_constexpr expected< void, detail::transform_invoke_result_t< F, const error_type && > > transform_error( F && f ) const &&
     {
-        return has_value()
+        return nsel_LIKELY( has_value() )
             ? expected< void, detail::transform_invoke_result_t< F, const error_type && > >()
-            : make_unexpected( detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
+            : expected< void, detail::transform_invoke_result_t< F, const error_type && > >( unexpect, detail::invoke( std::forward< F >( f ), std::move( error() ) ) );
     }
 #endif
 #endif // nsel_P2505R >= 3
@@ -3262,6 +4479,8 @@ private:
     contained;
 };
 
+#if nsel_CONFIG_RELATIONAL_OPERATORS
+
 // x.x.4.6 expected<>: comparison operators
 
 template< typename T1, typename E1, typename T2, typename E2
@@ -3481,6 +4700,7 @@ constexpr bool operator>=( unexpected_type<E> const & u, expected<T,E> const & x
 }
 
 #endif // nsel_P0323R
+#endif // nsel_CONFIG_RELATIONAL_OPERATORS
 
 /// x.x.x Specialized algorithms
 
@@ -3511,12 +4731,16 @@ auto inline make_expected() -> expected<void>
     return expected<void>( in_place );
 }
 
+#if nsel_CONFIG_CURRENT_EXCEPTION
+
 template< typename T >
 constexpr auto make_expected_from_current_exception() -> expected<T>
 {
     return expected<T>( make_unexpected_from_current_exception() );
 }
 
+#endif // nsel_CONFIG_CURRENT_EXCEPTION
+
 template< typename T >
 auto make_expected_from_exception( std::exception_ptr v ) -> expected<T>
 {
@@ -3529,6 +4753,8 @@ constexpr auto make_expected_from_error( E e ) -> expected<T, typename std::deca
     return expected<T, typename std::decay<E>::type>( make_unexpected( e ) );
 }
 
+#if nsel_CONFIG_CURRENT_EXCEPTION
+
 template< typename F
     nsel_REQUIRES_T( ! std::is_same<typename std::result_of<F()>::type, void>::value )
 >
@@ -3562,8 +4788,386 @@ auto make_expected_from_call( F f ) -> expected<void>
     }
 }
 
+#endif // nsel_CONFIG_CURRENT_EXCEPTION
 #endif // nsel_P0323R
 
+#if nsel_CONFIG_COROUTINES
+
+// coroutine support: a function returning expected<T,E> may be a coroutine;
+// co_await on an expected<U,G> yields its value or completes the coroutine with its error:
+
+namespace detail {
+
+template< typename T, typename E >
+class expected_promise;
+
+#if nsel_CONFIG_COROUTINE_FRAME_CACHE
+
+/// per-thread cache of the coroutine frames that the compiler did not elide.
+/// A frame doesn't outlive the call of its coroutine, so it returns to the
+/// thread that allocated it. Frames up to 1 kB are kept in size classes of
+/// 64 bytes, and freed when the thread ends.
+
+class coroutine_frame_cache
+{
+public:
+    nsel_noinline static void * allocate( std::size_t size )
+    {
+        if ( size == 0 || size > max_size )
+        {
+            return ::operator new( size );
+        }
+
+        block * & head = instance().m_free[ size_class( size ) ];
+
+        if ( block * b = head )
+        {
+            head = b->next;
+            return b;
+        }
+
+        return ::operator new( ( size_class( size ) + 1 ) * granularity );
+    }
+
+    nsel_noinline static void deallocate( void * p, std::size_t size ) noexcept
+    {
+        if ( size == 0 || size > max_size )
+        {
+            ::operator delete( p );
+            return;
+        }
+
+        block * & head = instance().m_free[ size_class( size ) ];
+
+        head = ::new( p ) block{ head };
+    }
+
+    coroutine_frame_cache() = default;
+    coroutine_frame_cache( coroutine_frame_cache const & ) = delete;
+    coroutine_frame_cache & operator=( coroutine_frame_cache const & ) = delete;
+
+    ~coroutine_frame_cache()
+    {
+        for ( block * head : m_free )
+        {
+            while ( head )
+            {
+                block * next = head->next;
+                ::operator delete( head );
+                head = next;
+            }
+        }
+    }
+
+private:
+    struct block
+    {
+        block * next;
+    };
+
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t classes     = 16;
+    static constexpr std::size_t max_size    = granularity * classes;
+
+    static std::size_t size_class( std::size_t size ) noexcept
+    {
+        return ( size - 1 ) / granularity;
+    }
+
+    static coroutine_frame_cache & instance() noexcept
+    {
+        static thread_local coroutine_frame_cache cache;
+        return cache;
+    }
+
+private:
+    block * m_free[ classes ] = {};
+};
+
+#endif // nsel_CONFIG_COROUTINE_FRAME_CACHE
+
+/// object returned to the caller of the coroutine; it owns the coroutine frame,
+/// and converts to the expected<T,E> that the promise holds once the coroutine
+/// has completed or stopped at an error.
+
+template< typename T, typename E >
+class expected_return_object
+{
+public:
+    using handle_type = std::coroutine_handle< expected_promise<T,E> >;
+
+    explicit expected_return_object( handle_type handle ) noexcept
+        : m_handle( handle )
+    {
+        m_handle.promise().m_owner = this;
+    }
+
+    expected_return_object( expected_return_object && other ) noexcept
+        : m_handle( other.m_handle )
+    {
+        other.m_handle = nullptr;
+        m_handle.promise().m_owner = this;
+    }
+
+    expected_return_object( expected_return_object const & ) = delete;
+    expected_return_object & operator=( expected_return_object const & ) = delete;
+    expected_return_object & operator=( expected_return_object && ) = delete;
+
+    ~expected_return_object()
+    {
+        if ( m_handle )
+        {
+            m_handle.destroy();
+        }
+    }
+
+    // requires the compiler to convert the return object after the coroutine body ran,
+    // see nsel_HAVE_COROUTINES:
+
+    operator expected<T,E>()
+    {
+        return std::move( m_handle.promise().result() );
+    }
+
+    void release() noexcept
+    {
+        m_handle = nullptr;
+    }
+
+private:
+    handle_type m_handle;
+};
+
+/// awaiter for co_await on an expected: ready with a value, stops the awaiting
+/// coroutine with the error otherwise; it is not resumed, but destroyed by the
+/// return object.
+
+template< typename Ex, typename U >
+class expected_awaiter
+{
+public:
+    explicit expected_awaiter( Ex && ex ) noexcept
+        : m_expected( std::forward<Ex>( ex ) )
+    {}
+
+    bool await_ready() const noexcept
+    {
+        return nsel_LIKELY( m_expected.has_value() );
+    }
+
+    template< typename Promise >
+    void await_suspend( std::coroutine_handle<Promise> handle )
+    {
+        handle.promise().return_error( std::forward<Ex>( m_expected ).error() );
+    }
+
+    U await_resume()
+    {
+        return *std::forward<Ex>( m_expected );
+    }
+
+private:
+    Ex && m_expected;
+};
+
+template< typename Ex >
+class expected_awaiter<Ex, void>
+{
+public:
+    explicit expected_awaiter( Ex && ex ) noexcept
+        : m_expected( std::forward<Ex>( ex ) )
+    {}
+
+    bool await_ready() const noexcept
+    {
+        return nsel_LIKELY( m_expected.has_value() );
+    }
+
+    template< typename Promise >
+    void await_suspend( std::coroutine_handle<Promise> handle )
+    {
+        handle.promise().return_error( std::forward<Ex>( m_expected ).error() );
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    Ex && m_expected;
+};
+
+/// promise part common to expected<T,E> and expected<void,E>; it holds the result.
+
+template< typename T, typename E >
+class expected_promise_base
+{
+public:
+    expected_promise_base() noexcept {}
+
+    expected_promise_base( expected_promise_base const & ) = delete;
+    expected_promise_base & operator=( expected_promise_base const & ) = delete;
+
+    ~expected_promise_base()
+    {
+        if ( m_has_result )
+        {
+            get()->~expected<T,E>();
+        }
+    }
+
+#if nsel_CONFIG_COROUTINE_FRAME_CACHE
+    static void * operator new( std::size_t size )
+    {
+        return coroutine_frame_cache::allocate( size );
+    }
+
+    static void operator delete( void * p, std::size_t size ) noexcept
+    {
+        coroutine_frame_cache::deallocate( p, size );
+    }
+#endif
+
+    expected_return_object<T,E> get_return_object() noexcept
+    {
+        return expected_return_object<T,E>(
+            std::coroutine_handle< expected_promise<T,E> >::from_promise( static_cast< expected_promise<T,E> & >( *this ) ) );
+    }
+
+    std::suspend_never initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    // keep the frame, and with it the result, until the return object is destroyed:
+
+    std::suspend_always final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    // the exception leaves the initial call of the coroutine, which then destroys
+    // the frame itself:
+
+    void unhandled_exception()
+    {
+#if nsel_CONFIG_NO_EXCEPTIONS
+        std::terminate();
+#else
+        m_owner->release();
+        throw;
+#endif
+    }
+
+    template< typename G >
+    void return_error( G && error )
+    {
+        emplace( unexpect, std::forward<G>( error ) );
+    }
+
+    expected<T,E> & result() noexcept
+    {
+        nsel_ASSERT( m_has_result );
+        return *get();
+    }
+
+    // lvalues yield a copy of the value, rvalues a moved value:
+
+    template< typename U, typename G >
+    expected_awaiter< expected<U,G> &, U > await_transform( expected<U,G> & ex ) noexcept
+    {
+        return expected_awaiter< expected<U,G> &, U >( ex );
+    }
+
+    template< typename U, typename G >
+    expected_awaiter< expected<U,G> const &, U > await_transform( expected<U,G> const & ex ) noexcept
+    {
+        return expected_awaiter< expected<U,G> const &, U >( ex );
+    }
+
+    template< typename U, typename G >
+    expected_awaiter< expected<U,G>, U > await_transform( expected<U,G> && ex ) noexcept
+    {
+        return expected_awaiter< expected<U,G>, U >( std::move( ex ) );
+    }
+
+protected:
+    template< typename... Args >
+    void emplace( Args&&... args )
+    {
+        nsel_ASSERT( ! m_has_result );
+        ::new( static_cast<void *>( m_buffer ) ) expected<T,E>( std::forward<Args>( args )... );
+        m_has_result = true;
+    }
+
+private:
+    expected<T,E> * get() noexcept
+    {
+        return reinterpret_cast< expected<T,E> * >( m_buffer );
+    }
+
+private:
+    friend class expected_return_object<T,E>;
+
+    expected_return_object<T,E> * m_owner = nullptr;
+    bool m_has_result = false;
+    alignas( expected<T,E> ) unsigned char m_buffer[ sizeof( expected<T,E> ) ];
+};
+
+template< typename T, typename E >
+class expected_promise : public expected_promise_base<T,E>
+{
+public:
+    template< typename U = T >
+    void return_value( U && v )
+    {
+        this->emplace( std::forward<U>( v ) );
+    }
+};
+
+template< typename E >
+class expected_promise<void, E> : public expected_promise_base<void, E>
+{
+public:
+    // co_return {}, co_return make_unexpected( e ):
+
+    void return_value( expected<void, E> && v )
+    {
+        this->emplace( std::move( v ) );
+    }
+};
+
+} // namespace detail
+
+#endif // nsel_CONFIG_COROUTINES
+
+#if nsel_CONFIG_EXTERN_TEMPLATES
+
+// explicit instantiations of expected, declared here and defined once in
+// library expected-lite-extern (src/expected.cpp defines nsel_EXTERN_TEMPLATES_DEFINITION):
+
+// Note: includes the storage of expected, hence T and E must be copy- and move-constructible.
+
+#ifdef nsel_EXTERN_TEMPLATES_DEFINITION
+# define nsel_EXTERN_TEMPLATE  template
+#else
+# define nsel_EXTERN_TEMPLATE  extern template
+#endif
+
+#define nsel_EXTERN_TEMPLATE_INSTANTIATION( T, E ) \
+    nsel_EXTERN_TEMPLATE class detail::storage_t_impl< T, E >; \
+    nsel_EXTERN_TEMPLATE class detail::storage_t_copy_construct< T, E >; \
+    nsel_EXTERN_TEMPLATE class detail::storage_t_move_construct< T, E >; \
+    nsel_EXTERN_TEMPLATE class detail::storage_t_copy_assign< T, E >; \
+    nsel_EXTERN_TEMPLATE class detail::storage_t_move_assign< T, E >; \
+    nsel_EXTERN_TEMPLATE class detail::storage_t< T, E, true, true >; \
+    nsel_EXTERN_TEMPLATE class expected< T, E >;
+
+nsel_CONFIG_EXTERN_TEMPLATE_TYPES( nsel_EXTERN_TEMPLATE_INSTANTIATION )
+
+#undef nsel_EXTERN_TEMPLATE
+#undef nsel_EXTERN_TEMPLATE_INSTANTIATION
+
+#endif // nsel_CONFIG_EXTERN_TEMPLATES
+
 } // namespace expected_lite
 
 using namespace expected_lite;
@@ -3575,6 +5179,8 @@ using namespace expected_lite;
 
 namespace std {
 
+#if nsel_CONFIG_HASH
+
 // expected: hash support
 
 template< typename T, typename E >
@@ -3612,13 +5218,27 @@ struct hash< nonstd::expected<void,E> >
 {
 };
 
+#endif // nsel_CONFIG_HASH
+
+#if nsel_CONFIG_COROUTINES
+
+// expected: coroutine support
+
+template< typename T, typename E, typename... Args >
+struct coroutine_traits< nonstd::expected<T,E>, Args... >
+{
+    using promise_type = nonstd::expected_lite::detail::expected_promise<T,E>;
+};
+
+#endif // nsel_CONFIG_COROUTINES
+
 } // namespace std
 
 namespace nonstd {
 
 // void unexpected() is deprecated && removed in C++17
 
-#if nsel_CPP17_OR_GREATER || nsel_COMPILER_MSVC_VERSION > 141
+#if ( nsel_CPP17_OR_GREATER || nsel_COMPILER_MSVC_VERSION > 141 ) && !defined( NONSTD_EXPECTED_LITE_FWD_HPP )
 template< typename E >
 using unexpected = unexpected_type<E>;
 #endif
@@ -3633,4 +5253,94 @@ nsel_RESTORE_WARNINGS()
 
 #endif // nsel_USES_STD_EXPECTED
 
+//
+// Early return of the error of an expected, for std::expected and nonstd::expected:
+//
+
+namespace nonstd {
+namespace try_detail {
+
+/// converts to any expected<T,G> that holds the error, constructed in place from Ref.
+
+template< typename Ref >
+class error_forwarder
+{
+public:
+    explicit error_forwarder( Ref error ) noexcept
+        : m_error( std::forward<Ref>( error ) )
+    {}
+
+    template< typename T, typename G >
+    operator expected<T,G>() const
+    {
+        return expected<T,G>( unexpect, std::forward<Ref>( m_error ) );
+    }
+
+private:
+    Ref m_error;
+};
+
+/// error of an rvalue expected is moved, of an lvalue expected is copied.
+
+template< typename E >
+error_forwarder<E &&> forward_error( E && error ) noexcept
+{
+    return error_forwarder<E &&>( std::forward<E>( error ) );
+}
+
+} // namespace try_detail
+} // namespace nonstd
+
+#define nsel_TRY_CONCAT_( a, b )  a ## b
+#define nsel_TRY_CONCAT(  a, b )  nsel_TRY_CONCAT_( a, b )
+
+#ifdef __COUNTER__
+# define nsel_TRY_NAME  nsel_TRY_CONCAT( nsel_try_result_, __COUNTER__ )
+#else
+# define nsel_TRY_NAME  nsel_TRY_CONCAT( nsel_try_result_, __LINE__ )
+#endif
+
+#define nsel_TRY_RETURN_ERROR_IF_( tmp ) \
+    if ( ! tmp.has_value() ) \
+        return ::nonstd::try_detail::forward_error( static_cast<decltype(tmp) &&>( tmp ).error() )
+
+/// nsel_TRY( var, expr ): evaluate expected expr, return its error from the enclosing
+/// function, or initialize or assign var with its value, e.g. nsel_TRY( auto x, parse( s ) );
+/// the value and error of an rvalue expr are moved, those of an lvalue expr are copied.
+///
+/// nsel_TRY_VOID( expr ): evaluate expected expr and return its error from the enclosing function.
+
+#if nsel_CONFIG_TRY_STATEMENT_EXPRESSION
+
+// note: the value of a statement expression keeps its cv-qualification,
+// hence the cast to the non-const value type to move rather than copy it:
+
+# define nsel_TRY( var, expr )  nsel_TRY_( var, expr, nsel_TRY_NAME )
+
+# define nsel_TRY_( var, expr, tmp ) \
+    var = __extension__ ({ \
+        auto && tmp = ( expr ); \
+        nsel_TRY_RETURN_ERROR_IF_( tmp ); \
+        static_cast< typename std::decay<decltype(*tmp)>::type >( *static_cast<decltype(tmp) &&>( tmp ) ); \
+    })
+
+#else // nsel_CONFIG_TRY_STATEMENT_EXPRESSION
+
+# define nsel_TRY( var, expr )  nsel_TRY_( var, expr, nsel_TRY_NAME )
+
+# define nsel_TRY_( var, expr, tmp ) \
+    auto && tmp = ( expr ); \
+    nsel_TRY_RETURN_ERROR_IF_( tmp ); \
+    var = *static_cast<decltype(tmp) &&>( tmp )
+
+#endif // nsel_CONFIG_TRY_STATEMENT_EXPRESSION
+
+#define nsel_TRY_VOID( expr )  nsel_TRY_VOID_( expr, nsel_TRY_NAME )
+
+#define nsel_TRY_VOID_( expr, tmp ) \
+    do { \
+        auto && tmp = ( expr ); \
+        nsel_TRY_RETURN_ERROR_IF_( tmp ); \
+    } while ( false )
+
 #endif // NONSTD_EXPECTED_LITE_HPP
@@ -0,0 +1,362 @@
+// This version targets C++11 and later.
+//
+// Copyright (C) 2016-2025 Martin Moene.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// expected lite batch: a sequence of results like expected<T,E> of which very
+// few fail, kept as a dense array of values, one per element, and a side table
+// of the failed elements with their error, sorted by index, e.g.
+//
+//   nonstd::sparse_expected_batch<Record, std::error_code> batch;
+//
+//   batch.push_back( parse( line ) );
+//
+//   if ( batch.has_errors() )
+//       for ( auto const & f : batch.errors() ) log( f.index, f.error );
+//
+// A failed element has a value-initialized T in the array of values, so that
+// the values remain one per element; the error lives only in the side table.
+
+#ifndef NONSTD_EXPECTED_LITE_BATCH_HPP
+#define NONSTD_EXPECTED_LITE_BATCH_HPP
+
+#include "expected_vector.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if nsel_USES_STD_EXPECTED
+# define nsel_BATCH_ASSERT( expr )  assert( expr )
+#else
+# define nsel_BATCH_ASSERT( expr )  nsel_ASSERT( expr )
+#endif
+
+namespace nonstd {
+namespace expected_lite {
+
+namespace detail {
+
+/// view of a failed element of sparse_expected_batch: the index is a copy, so
+/// that the table stays sorted, the error refers to the one in the table:
+
+template< typename E >
+struct expected_batch_failure_reference
+{
+    std::size_t const index;
+    E &               error;
+};
+
+/// iterator over the table of failures, which yields views:
+
+template< typename Iterator, typename Reference >
+class expected_batch_failure_iterator
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Reference;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = Reference;
+
+    explicit expected_batch_failure_iterator( Iterator pos ) noexcept
+        : m_pos( pos )
+    {}
+
+    reference operator*() const
+    {
+        return reference{ m_pos->index, m_pos->error };
+    }
+
+    expected_batch_failure_iterator & operator++() noexcept
+    {
+        ++m_pos;
+        return *this;
+    }
+
+    expected_batch_failure_iterator operator++( int ) noexcept
+    {
+        expected_batch_failure_iterator result( *this );
+        ++m_pos;
+        return result;
+    }
+
+    friend bool operator==( expected_batch_failure_iterator const & a, expected_batch_failure_iterator const & b ) noexcept
+    {
+        return a.m_pos == b.m_pos;
+    }
+
+    friend bool operator!=( expected_batch_failure_iterator const & a, expected_batch_failure_iterator const & b ) noexcept
+    {
+        return a.m_pos != b.m_pos;
+    }
+
+private:
+    Iterator m_pos;
+};
+
+} // namespace detail
+
+/// sequence of results like expected<T,E> for low failure rates: a value per
+/// element and the errors of the failed elements in a table sorted by index;
+/// elements are appended, not inserted.
+///
+/// Access to an element of a batch without errors costs a comparison, with
+/// errors a binary search of the table. Adding an element gives the strong
+/// exception guarantee. Views of elements are invalidated as the references
+/// to the elements of std::vector<T> and of the table are.
+
+template< typename T, typename E >
+class sparse_expected_batch
+{
+    static_assert( ! std::is_void<T>::value, "sparse_expected_batch<T,E>: T must not be void" );
+    static_assert( ! std::is_same<T, bool>::value, "sparse_expected_batch<T,E>: T must not be bool, as std::vector<bool> provides no references" );
+
+public:
+    using value_type      = T;
+    using error_type      = E;
+    using size_type       = std::size_t;
+    using reference       = expected_vector_reference<T, E>;
+    using const_reference = expected_vector_reference<T const, E const>;
+    using iterator        = detail::expected_vector_iterator<sparse_expected_batch, reference>;
+    using const_iterator  = detail::expected_vector_iterator<sparse_expected_batch const, const_reference>;
+
+    /// a failed element:
+
+    struct failure
+    {
+        size_type  index;
+        error_type error;
+    };
+
+    using failure_reference   = detail::expected_batch_failure_reference<E>;
+    using failure_iterator    = detail::expected_batch_failure_iterator<typename std::vector<failure>::iterator, failure_reference>;
+    using failure_range       = detail::expected_vector_range<failure_iterator>;
+    using const_failure_range = detail::expected_vector_range<typename std::vector<failure>::const_iterator>;
+
+    // capacity:
+
+    size_type size() const noexcept
+    {
+        return m_values.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_values.empty();
+    }
+
+    /// reserve room for n elements and for the given number of failures:
+
+    void reserve( size_type n, size_type failures = 0 )
+    {
+        m_values.reserve( n );
+        m_failures.reserve( failures );
+    }
+
+    void clear() noexcept
+    {
+        m_values.clear();
+        m_failures.clear();
+    }
+
+    // modifiers:
+
+    void push_back( expected<T, E> const & x )
+    {
+        if ( x.has_value() ) emplace_back( *x );
+        else                 emplace_error_back( x.error() );
+    }
+
+    void push_back( expected<T, E> && x )
+    {
+        if ( x.has_value() ) emplace_back( std::move( *x ) );
+        else                 emplace_error_back( std::move( x.error() ) );
+    }
+
+    void push_back( T const & value )
+    {
+        emplace_back( value );
+    }
+
+    void push_back( T && value )
+    {
+        emplace_back( std::move( value ) );
+    }
+
+    void push_back( unexpected_type<E> const & error )
+    {
+        emplace_error_back( error.error() );
+    }
+
+    void push_back( unexpected_type<E> && error )
+    {
+        emplace_error_back( std::move( error.error() ) );
+    }
+
+    template< typename... Args >
+    reference emplace_back( Args &&... args )
+    {
+        m_values.emplace_back( std::forward<Args>( args )... );
+
+        return reference( &m_values.back(), nullptr );
+    }
+
+    /// append a failed element; requires T to be default-constructible:
+
+    template< typename... Args >
+    reference emplace_error_back( Args &&... args )
+    {
+        m_values.emplace_back();
+
+#if nsel_CONFIG_NO_EXCEPTIONS
+        m_failures.push_back( failure{ m_values.size() - 1, error_type( std::forward<Args>( args )... ) } );
+#else
+        try
+        {
+            m_failures.push_back( failure{ m_values.size() - 1, error_type( std::forward<Args>( args )... ) } );
+        }
+        catch ( ... )
+        {
+            m_values.pop_back();
+            throw;
+        }
+#endif
+
+        return reference( nullptr, &m_failures.back().error );
+    }
+
+    // element access:
+
+    reference operator[]( size_type i )
+    {
+        nsel_BATCH_ASSERT( i < size() );
+
+        const size_type f = failure_of( i );
+
+        return f < m_failures.size() ? reference( nullptr, &m_failures[ f ].error ) : reference( &m_values[ i ], nullptr );
+    }
+
+    const_reference operator[]( size_type i ) const
+    {
+        nsel_BATCH_ASSERT( i < size() );
+
+        const size_type f = failure_of( i );
+
+        return f < m_failures.size() ? const_reference( nullptr, &m_failures[ f ].error ) : const_reference( &m_values[ i ], nullptr );
+    }
+
+    reference at( size_type i )
+    {
+        return check( i ), ( *this )[ i ];
+    }
+
+    const_reference at( size_type i ) const
+    {
+        return check( i ), ( *this )[ i ];
+    }
+
+    bool has_value( size_type i ) const
+    {
+        return nsel_BATCH_ASSERT( i < size() ), failure_of( i ) == m_failures.size();
+    }
+
+    // iteration over all elements, the values, one per element, and the failures:
+
+    iterator       begin()        noexcept { return iterator( this, 0 ); }
+    iterator       end()          noexcept { return iterator( this, size() ); }
+    const_iterator begin()  const noexcept { return const_iterator( this, 0 ); }
+    const_iterator end()    const noexcept { return const_iterator( this, size() ); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+    /// the values, with a value-initialized T for each failed element:
+
+    std::vector<T> const & values() const noexcept
+    {
+        return m_values;
+    }
+
+    /// the failed elements in order of their index; via a non-const batch, only
+    /// their errors are mutable:
+
+    failure_range       errors()       { return failure_range      ( failure_iterator( m_failures.begin() ), failure_iterator( m_failures.end() ) ); }
+    const_failure_range errors() const { return const_failure_range( m_failures.begin(), m_failures.end() ); }
+
+    // counts and search:
+
+    bool has_errors() const noexcept
+    {
+        return ! m_failures.empty();
+    }
+
+    size_type count_values() const noexcept
+    {
+        return m_values.size() - m_failures.size();
+    }
+
+    size_type count_errors() const noexcept
+    {
+        return m_failures.size();
+    }
+
+    /// the index of the first error at or after from, size() if there is none:
+
+    size_type first_error( size_type from = 0 ) const
+    {
+        typename std::vector<failure>::const_iterator pos = lower_bound( from );
+
+        return pos != m_failures.end() ? pos->index : size();
+    }
+
+private:
+    typename std::vector<failure>::const_iterator lower_bound( size_type i ) const
+    {
+        return std::lower_bound( m_failures.begin(), m_failures.end(), i
+            , []( failure const & f, size_type index ) { return f.index < index; } );
+    }
+
+    // the position of the failure of element i in the table, its size if there
+    // is none; no search without failures or beyond the last failure:
+
+    size_type failure_of( size_type i ) const
+    {
+        if ( m_failures.empty() || m_failures.back().index < i )
+            return m_failures.size();
+
+        const size_type pos = static_cast<size_type>( lower_bound( i ) - m_failures.begin() );
+
+        return m_failures[ pos ].index == i ? pos : m_failures.size();
+    }
+
+    void check( size_type i ) const
+    {
+#if nsel_CONFIG_NO_EXCEPTIONS
+        nsel_BATCH_ASSERT( i < size() );
+#else
+        if ( i >= size() )
+            throw std::out_of_range( "sparse_expected_batch::at()" );
+#endif
+    }
+
+private:
+    std::vector<T>       m_values;
+    std::vector<failure> m_failures;
+};
+
+} // namespace expected_lite
+
+using expected_lite::sparse_expected_batch;
+
+} // namespace nonstd
+
+#undef nsel_BATCH_ASSERT
+
+#endif // NONSTD_EXPECTED_LITE_BATCH_HPP
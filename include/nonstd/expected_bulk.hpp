@@ -0,0 +1,655 @@
+// This version targets C++11 and later.
+//
+// Copyright (C) 2016-2025 Martin Moene.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// expected lite bulk: algorithms over a contiguous array of expected<T,E> with
+// an arithmetic T and a trivially copyable E, such as an enumeration, e.g.
+//
+//   std::vector< nonstd::expected<float, sensor_error> > samples = ...;
+//
+//   std::size_t good  = nonstd::count_values( samples.data(), samples.size() );
+//   std::size_t first = nonstd::find_error( samples.data(), samples.size() );
+//
+// With the discriminant of expected<T,E> in a bool flag, count_values(),
+// find_error() and partition_indices() test the flags of a series of elements
+// 16, 32 or 64 bytes at a time with SSE2, AVX2 or AVX-512BW, selected at run
+// time. With a value of 4 or 8 bytes directly followed by the flag, values_or()
+// separates the values from the flags with shuffles. Other layouts, std::expected
+// and other platforms use a scalar loop, as does the tail of the array.
+
+#ifndef NONSTD_EXPECTED_LITE_BULK_HPP
+#define NONSTD_EXPECTED_LITE_BULK_HPP
+
+#include "expected_layout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Control use of SSE2, AVX2 and AVX-512BW in the bulk algorithms, default on:
+
+#ifndef  nsel_CONFIG_BULK_SIMD
+# define nsel_CONFIG_BULK_SIMD  1
+#endif
+
+// SSE2 is part of x86-64; AVX2 and AVX-512BW need selection at run time via the
+// target attribute and __builtin_cpu_supports() of GCC and clang:
+
+#if nsel_CONFIG_BULK_SIMD && !nsel_USES_STD_EXPECTED && ( defined( __x86_64__ ) || defined( _M_X64 ) )
+# define nsel_BULK_SSE2  1
+# include <emmintrin.h>
+#else
+# define nsel_BULK_SSE2  0
+#endif
+
+#if nsel_BULK_SSE2 && ( nsel_COMPILER_GNUC_VERSION >= 800 || nsel_COMPILER_CLANG_VERSION >= 600 )
+# define nsel_BULK_AVX  1
+# include <immintrin.h>
+# define nsel_BULK_TARGET_AVX2    __attribute__((target("avx2")))
+# define nsel_BULK_TARGET_AVX512  __attribute__((target("avx512f,avx512bw")))
+#else
+# define nsel_BULK_AVX  0
+#endif
+
+namespace nonstd {
+namespace expected_lite {
+
+/// the instruction set of the bulk algorithms, in increasing order:
+
+enum class bulk_isa
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512bw
+};
+
+namespace detail {
+
+inline bulk_isa detect_bulk_isa() noexcept
+{
+#if nsel_BULK_AVX
+    __builtin_cpu_init();
+
+    if ( __builtin_cpu_supports( "avx512bw" ) ) return bulk_isa::avx512bw;
+    if ( __builtin_cpu_supports( "avx2"     ) ) return bulk_isa::avx2;
+#endif
+#if nsel_BULK_SSE2
+    return bulk_isa::sse2;
+#else
+    return bulk_isa::scalar;
+#endif
+}
+
+} // namespace detail
+
+/// the best instruction set for the bulk algorithms on this machine:
+
+inline bulk_isa detected_bulk_isa() noexcept
+{
+    static const bulk_isa isa = detail::detect_bulk_isa();
+    return isa;
+}
+
+namespace detail {
+
+#if nsel_USES_STD_EXPECTED || nsel_HAVE_IS_TRIVIALLY_COPYABLE
+template< typename T > struct bulk_is_trivially_copyable : std::is_trivially_copyable<T> {};
+#else
+// conservative approximation:
+template< typename T > struct bulk_is_trivially_copyable : std::is_trivially_destructible<T> {};
+#endif
+
+/// the properties of expected<T,E> the bulk algorithms rely on:
+
+template< typename T, typename E >
+struct bulk_layout
+{
+    static_assert( std::is_arithmetic<T>::value, "bulk algorithms: T must be an arithmetic type" );
+    static_assert( bulk_is_trivially_copyable<E>::value, "bulk algorithms: E must be trivially copyable" );
+
+    static constexpr std::size_t stride = sizeof( expected<T, E> );
+    static constexpr std::size_t offset = layout_report<T, E>().discriminant_offset;
+
+    // the flags of a series of elements in a vector register: a bool flag, power-of-two stride:
+
+    static constexpr bool flag = layout_report<T, E>().discriminant == layout_discriminant::flag
+        && layout_report<T, E>().discriminant_size == 1 && ( stride & ( stride - 1 ) ) == 0;
+
+    // the value first, of 4 or 8 bytes, directly followed by the flag:
+
+    static constexpr bool packed = flag && layout_report<T, E>().value_offset == 0
+        && offset == sizeof( T ) && stride == 2 * sizeof( T ) && ( sizeof( T ) == 4 || sizeof( T ) == 8 );
+
+    // the bits of the flags in a chunk of width bytes:
+
+    static constexpr std::uint64_t flag_bits( std::size_t width, std::size_t at = offset )
+    {
+        return at >= width ? 0 : ( std::uint64_t( 1 ) << at ) | flag_bits( width, at + stride );
+    }
+
+    static unsigned char const * bytes( expected<T, E> const * p ) noexcept
+    {
+        return reinterpret_cast<unsigned char const *>( p );
+    }
+
+    // the value of an element that has one, without the check of operator*:
+
+    static T value( expected<T, E> const * p ) noexcept
+    {
+        T v;
+        std::memcpy( &v, bytes( p ) + layout_report<T, E>().value_offset, sizeof( T ) );
+        return v;
+    }
+};
+
+inline std::size_t countr_zero( std::uint64_t x ) noexcept
+{
+#if defined( __GNUC__ )
+    return static_cast<std::size_t>( __builtin_ctzll( x ) );
+#else
+    std::size_t n = 0;
+    for ( ; ( x & 1 ) == 0; x >>= 1 )
+        ++n;
+    return n;
+#endif
+}
+
+// per instruction set: nonzero() gives a bit per nonzero byte of a chunk of
+// width bytes, sum_flags() sums the bytes selected by mask over n chunks, bytes
+// that are 0 or 1, in runs of 255 chunks that cannot overflow a byte.
+//
+// select() reads two chunks of elements of 4 or 8 bytes of value followed by
+// the flag and writes a chunk of the values, or def for an element without a
+// value; only the low byte of the word with the flag is part of it:
+
+using word4 = std::integral_constant<std::size_t, 4>;
+using word8 = std::integral_constant<std::size_t, 8>;
+
+template< std::size_t Width >
+void expand_mask( unsigned char (&bytes)[Width], std::uint64_t mask ) noexcept
+{
+    for ( std::size_t i = 0; i < Width; ++i )
+        bytes[i] = ( mask >> i ) & 1 ? 0xFF : 0;
+}
+
+#if nsel_BULK_SSE2
+
+struct chunk_sse2
+{
+    static const std::size_t width = 16;
+
+    static std::uint64_t nonzero( unsigned char const * p ) noexcept
+    {
+        const __m128i v = _mm_loadu_si128( reinterpret_cast<__m128i const *>( p ) );
+        return ~static_cast<std::uint64_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_setzero_si128() ) ) ) & 0xFFFFu;
+    }
+
+    static std::size_t sum_flags( unsigned char const * p, std::size_t n, std::uint64_t mask ) noexcept
+    {
+        unsigned char bytes[ width ];
+        expand_mask( bytes, mask );
+
+        const __m128i select = _mm_loadu_si128( reinterpret_cast<__m128i const *>( bytes ) );
+        std::size_t sum = 0;
+
+        while ( n )
+        {
+            const std::size_t run = n < 255 ? n : 255;
+            __m128i acc = _mm_setzero_si128();
+
+            for ( std::size_t i = 0; i < run; ++i, p += width )
+                acc = _mm_add_epi8( acc, _mm_and_si128( _mm_loadu_si128( reinterpret_cast<__m128i const *>( p ) ), select ) );
+
+            const __m128i s = _mm_sad_epu8( acc, _mm_setzero_si128() );
+            sum += static_cast<std::size_t>( _mm_cvtsi128_si32( s ) + _mm_cvtsi128_si32( _mm_srli_si128( s, 8 ) ) );
+            n -= run;
+        }
+        return sum;
+    }
+
+    static void select( word4, unsigned char const * p, void * out, std::uint32_t def ) noexcept
+    {
+        const __m128 a = _mm_loadu_ps( reinterpret_cast<float const *>( p ) );
+        const __m128 b = _mm_loadu_ps( reinterpret_cast<float const *>( p + width ) );
+
+        const __m128i values = _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        const __m128i flags  = _mm_and_si128( _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) ), _mm_set1_epi32( 0xFF ) );
+
+        store( out, values, _mm_cmpeq_epi32( flags, _mm_setzero_si128() ), _mm_set1_epi32( static_cast<int>( def ) ) );
+    }
+
+    static void select( word8, unsigned char const * p, void * out, std::uint64_t def ) noexcept
+    {
+        const __m128i a = _mm_loadu_si128( reinterpret_cast<__m128i const *>( p ) );
+        const __m128i b = _mm_loadu_si128( reinterpret_cast<__m128i const *>( p + width ) );
+
+        // without a 64-bit compare, compare the low half of each quadword and copy the result to the high half:
+
+        const __m128i values = _mm_unpacklo_epi64( a, b );
+        const __m128i flags  = _mm_and_si128( _mm_unpackhi_epi64( a, b ), _mm_set1_epi64x( 0xFF ) );
+        const __m128i none   = _mm_shuffle_epi32( _mm_cmpeq_epi32( flags, _mm_setzero_si128() ), _MM_SHUFFLE( 2, 2, 0, 0 ) );
+
+        store( out, values, none, _mm_set1_epi64x( static_cast<long long>( def ) ) );
+    }
+
+    static void store( void * out, __m128i values, __m128i none, __m128i def ) noexcept
+    {
+        _mm_storeu_si128( static_cast<__m128i *>( out ), _mm_or_si128( _mm_and_si128( none, def ), _mm_andnot_si128( none, values ) ) );
+    }
+};
+
+#endif // nsel_BULK_SSE2
+
+#if nsel_BULK_AVX
+
+struct chunk_avx2
+{
+    static const std::size_t width = 32;
+
+    static nsel_BULK_TARGET_AVX2 std::uint64_t nonzero( unsigned char const * p ) noexcept
+    {
+        const __m256i v = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) );
+        return ~static_cast<std::uint64_t>( static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) ) ) ) & 0xFFFFFFFFu;
+    }
+
+    static nsel_BULK_TARGET_AVX2 std::size_t sum_flags( unsigned char const * p, std::size_t n, std::uint64_t mask ) noexcept
+    {
+        unsigned char bytes[ width ];
+        expand_mask( bytes, mask );
+
+        const __m256i select = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( bytes ) );
+        std::size_t sum = 0;
+
+        while ( n )
+        {
+            const std::size_t run = n < 255 ? n : 255;
+            __m256i acc = _mm256_setzero_si256();
+
+            for ( std::size_t i = 0; i < run; ++i, p += width )
+                acc = _mm256_add_epi8( acc, _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) ), select ) );
+
+            const __m256i s2 = _mm256_sad_epu8( acc, _mm256_setzero_si256() );
+            const __m128i s  = _mm_add_epi64( _mm256_castsi256_si128( s2 ), _mm256_extracti128_si256( s2, 1 ) );
+            sum += static_cast<std::size_t>( _mm_cvtsi128_si32( s ) + _mm_cvtsi128_si32( _mm_srli_si128( s, 8 ) ) );
+            n -= run;
+        }
+        return sum;
+    }
+
+    // the shuffles work per 128-bit lane, the permutation restores the order:
+
+    static nsel_BULK_TARGET_AVX2 void select( word4, unsigned char const * p, void * out, std::uint32_t def ) noexcept
+    {
+        const __m256 a = _mm256_loadu_ps( reinterpret_cast<float const *>( p ) );
+        const __m256 b = _mm256_loadu_ps( reinterpret_cast<float const *>( p + width ) );
+
+        const __m256i values = _mm256_castps_si256( _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        const __m256i flags  = _mm256_and_si256( _mm256_castps_si256( _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) ), _mm256_set1_epi32( 0xFF ) );
+        const __m256i none   = _mm256_cmpeq_epi32( flags, _mm256_setzero_si256() );
+
+        store( out, _mm256_permute4x64_epi64( _mm256_blendv_epi8( values, _mm256_set1_epi32( static_cast<int>( def ) ), none ), _MM_SHUFFLE( 3, 1, 2, 0 ) ) );
+    }
+
+    static nsel_BULK_TARGET_AVX2 void select( word8, unsigned char const * p, void * out, std::uint64_t def ) noexcept
+    {
+        const __m256i a = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) );
+        const __m256i b = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p + width ) );
+
+        const __m256i values = _mm256_unpacklo_epi64( a, b );
+        const __m256i flags  = _mm256_and_si256( _mm256_unpackhi_epi64( a, b ), _mm256_set1_epi64x( 0xFF ) );
+        const __m256i none   = _mm256_cmpeq_epi64( flags, _mm256_setzero_si256() );
+
+        store( out, _mm256_permute4x64_epi64( _mm256_blendv_epi8( values, _mm256_set1_epi64x( static_cast<long long>( def ) ), none ), _MM_SHUFFLE( 3, 1, 2, 0 ) ) );
+    }
+
+    static nsel_BULK_TARGET_AVX2 void store( void * out, __m256i values ) noexcept
+    {
+        _mm256_storeu_si256( static_cast<__m256i *>( out ), values );
+    }
+};
+
+struct chunk_avx512
+{
+    static const std::size_t width = 64;
+
+    static nsel_BULK_TARGET_AVX512 std::uint64_t nonzero( unsigned char const * p ) noexcept
+    {
+        const __m512i v = _mm512_loadu_si512( p );
+        return static_cast<std::uint64_t>( _mm512_test_epi8_mask( v, v ) );
+    }
+
+    static nsel_BULK_TARGET_AVX512 std::size_t sum_flags( unsigned char const * p, std::size_t n, std::uint64_t mask ) noexcept
+    {
+        const __m512i select = _mm512_maskz_set1_epi8( static_cast<__mmask64>( mask ), 1 );
+        std::size_t sum = 0;
+
+        while ( n )
+        {
+            const std::size_t run = n < 255 ? n : 255;
+            __m512i acc = _mm512_setzero_si512();
+
+            for ( std::size_t i = 0; i < run; ++i, p += width )
+                acc = _mm512_add_epi8( acc, _mm512_and_si512( _mm512_loadu_si512( p ), select ) );
+
+            std::uint64_t lanes[8];
+            _mm512_storeu_si512( lanes, _mm512_sad_epu8( acc, _mm512_setzero_si512() ) );
+
+            for ( std::uint64_t lane : lanes )
+                sum += static_cast<std::size_t>( lane );
+            n -= run;
+        }
+        return sum;
+    }
+
+    static nsel_BULK_TARGET_AVX512 void select( word4, unsigned char const * p, void * out, std::uint32_t def ) noexcept
+    {
+        const __m512i a = _mm512_loadu_si512( p );
+        const __m512i b = _mm512_loadu_si512( p + width );
+
+        const __m512i even = _mm512_set_epi32( 30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0 );
+        const __m512i odd  = _mm512_add_epi32( even, _mm512_set1_epi32( 1 ) );
+
+        const __m512i   values = _mm512_permutex2var_epi32( a, even, b );
+        const __mmask16 has    = _mm512_test_epi32_mask( _mm512_permutex2var_epi32( a, odd, b ), _mm512_set1_epi32( 0xFF ) );
+
+        _mm512_storeu_si512( out, _mm512_mask_blend_epi32( has, _mm512_set1_epi32( static_cast<int>( def ) ), values ) );
+    }
+
+    static nsel_BULK_TARGET_AVX512 void select( word8, unsigned char const * p, void * out, std::uint64_t def ) noexcept
+    {
+        const __m512i a = _mm512_loadu_si512( p );
+        const __m512i b = _mm512_loadu_si512( p + width );
+
+        const __m512i even = _mm512_set_epi64( 14, 12, 10, 8, 6, 4, 2, 0 );
+        const __m512i odd  = _mm512_add_epi64( even, _mm512_set1_epi64( 1 ) );
+
+        const __m512i  values = _mm512_permutex2var_epi64( a, even, b );
+        const __mmask8 has    = _mm512_test_epi64_mask( _mm512_permutex2var_epi64( a, odd, b ), _mm512_set1_epi64( 0xFF ) );
+
+        _mm512_storeu_si512( out, _mm512_mask_blend_epi64( has, _mm512_set1_epi64( static_cast<long long>( def ) ), values ) );
+    }
+};
+
+#endif // nsel_BULK_AVX
+
+// the algorithms per chunk of elements; run<Chunk>() handles the whole chunks
+// and returns the number of elements it handled:
+
+template< typename T, typename E >
+struct count_values_op
+{
+    using layout = bulk_layout<T, E>;
+
+    expected<T, E> const * first;
+    std::size_t n;
+    std::size_t count;
+
+    template< typename Chunk >
+    std::size_t run() noexcept
+    {
+        const std::size_t per_chunk = Chunk::width / layout::stride;
+        const std::size_t chunks    = n / per_chunk;
+
+        count = Chunk::sum_flags( layout::bytes( first ), chunks, layout::flag_bits( Chunk::width ) );
+        return chunks * per_chunk;
+    }
+};
+
+template< typename T, typename E >
+struct find_error_op
+{
+    using layout = bulk_layout<T, E>;
+
+    expected<T, E> const * first;
+    std::size_t n;
+    std::size_t found;
+
+    template< typename Chunk >
+    std::size_t run() noexcept
+    {
+        const std::size_t per_chunk = Chunk::width / layout::stride;
+        const std::uint64_t flags   = layout::flag_bits( Chunk::width );
+
+        std::size_t i = 0;
+        for ( ; i + per_chunk <= n; i += per_chunk )
+        {
+            if ( const std::uint64_t errors = ~Chunk::nonzero( layout::bytes( first + i ) ) & flags )
+            {
+                found = i + ( countr_zero( errors ) - layout::offset ) / layout::stride;
+                return n;
+            }
+        }
+        return i;
+    }
+};
+
+template< typename T, typename E >
+struct values_or_op
+{
+    using layout = bulk_layout<T, E>;
+
+    expected<T, E> const * first;
+    std::size_t n;
+    T * out;
+    T default_value;
+
+    template< typename Chunk >
+    std::size_t run() noexcept
+    {
+        return run_packed<Chunk>( std::integral_constant<bool, layout::packed>() );
+    }
+
+    // other layouts: the scalar loop is as fast as a test of the flags per chunk:
+
+    template< typename Chunk >
+    std::size_t run_packed( std::false_type ) noexcept
+    {
+        return 0;
+    }
+
+    template< typename Chunk >
+    std::size_t run_packed( std::true_type ) noexcept
+    {
+        using word = typename std::conditional< sizeof( T ) == 4, std::uint32_t, std::uint64_t >::type;
+
+        const std::size_t per_chunk = Chunk::width / sizeof( T );
+
+        word def;
+        std::memcpy( &def, &default_value, sizeof( T ) );
+
+        std::size_t i = 0;
+        for ( ; i + per_chunk <= n; i += per_chunk )
+            Chunk::select( std::integral_constant<std::size_t, sizeof( T )>(), layout::bytes( first + i ), out + i, def );
+
+        return i;
+    }
+};
+
+template< typename T, typename E >
+struct partition_indices_op
+{
+    using layout = bulk_layout<T, E>;
+
+    expected<T, E> const * first;
+    std::size_t n;
+    std::size_t * values;
+    std::size_t * errors;
+
+    // write the index to both and advance one, without a branch; requires
+    // room for one index past the last one of each:
+
+    void put( std::size_t i, bool has_value ) noexcept
+    {
+        *values = i;
+        *errors = i;
+        values += has_value;
+        errors += ! has_value;
+    }
+
+    template< typename Chunk >
+    std::size_t run() noexcept
+    {
+        const std::size_t per_chunk = Chunk::width / layout::stride;
+        const std::uint64_t flags   = layout::flag_bits( Chunk::width );
+
+        std::size_t i = 0;
+        for ( ; i + per_chunk <= n; i += per_chunk )
+        {
+            const std::uint64_t has = Chunk::nonzero( layout::bytes( first + i ) ) & flags;
+
+            for ( std::size_t k = 0; k < per_chunk; ++k )
+                put( i + k, ( has >> ( layout::offset + k * layout::stride ) ) & 1 );
+        }
+        return i;
+    }
+};
+
+// run an algorithm for the instruction set, return the number of elements handled;
+// flatten inlines the functions of the chunk, compiled for the same target:
+
+#if nsel_BULK_AVX
+template< typename Op >
+nsel_BULK_TARGET_AVX512 __attribute__((flatten)) std::size_t run_avx512( Op & op )
+{
+    return op.template run<chunk_avx512>();
+}
+
+template< typename Op >
+nsel_BULK_TARGET_AVX2 __attribute__((flatten)) std::size_t run_avx2( Op & op )
+{
+    return op.template run<chunk_avx2>();
+}
+#endif
+
+template< typename T, typename E, typename Op >
+std::size_t run_bulk( Op & op, bulk_isa isa )
+{
+    using layout = bulk_layout<T, E>;
+
+    if ( ! layout::flag )
+        return 0;
+
+    if ( isa > detected_bulk_isa() )
+        isa = detected_bulk_isa();
+
+#if nsel_BULK_AVX
+    if ( isa >= bulk_isa::avx512bw && layout::stride <= chunk_avx512::width ) return run_avx512( op );
+    if ( isa >= bulk_isa::avx2     && layout::stride <= chunk_avx2::width   ) return run_avx2( op );
+#endif
+#if nsel_BULK_SSE2
+    if ( isa >= bulk_isa::sse2     && layout::stride <= chunk_sse2::width   ) return op.template run<chunk_sse2>();
+#endif
+    return 0;
+}
+
+} // namespace detail
+
+/// the number of elements of [first, first + n) that hold a value:
+
+template< typename T, typename E >
+std::size_t count_values( expected<T, E> const * first, std::size_t n, bulk_isa isa = detected_bulk_isa() )
+{
+    detail::count_values_op<T, E> op = { first, n, 0 };
+
+    std::size_t i = detail::run_bulk<T, E>( op, isa );
+
+    for ( ; i < n; ++i )
+        op.count += first[i].has_value();
+
+    return op.count;
+}
+
+/// the index of the first element of [first, first + n) that holds an error, n if there is none:
+
+template< typename T, typename E >
+std::size_t find_error( expected<T, E> const * first, std::size_t n, bulk_isa isa = detected_bulk_isa() )
+{
+    detail::find_error_op<T, E> op = { first, n, n };
+
+    std::size_t i = detail::run_bulk<T, E>( op, isa );
+
+    for ( ; i < n; ++i )
+    {
+        if ( ! first[i].has_value() )
+            return i;
+    }
+    return op.found;
+}
+
+/// out[i] = first[i].value_or( default_value ) for the n elements:
+
+template< typename T, typename E >
+void values_or( expected<T, E> const * first, std::size_t n, T * out, T default_value, bulk_isa isa = detected_bulk_isa() )
+{
+    detail::values_or_op<T, E> op = { first, n, out, default_value };
+
+    std::size_t i = detail::run_bulk<T, E>( op, isa );
+
+    for ( ; i < n; ++i )
+        out[i] = first[i].has_value() ? *first[i] : default_value;
+}
+
+/// out[i] = first[i].transform( f ) for the n elements, with f called for the
+/// values only; a scalar loop, as the construction of the results outweighs a
+/// test of the flags per chunk:
+
+template< typename T, typename E, typename U, typename F >
+void transform_values( expected<T, E> const * first, std::size_t n, expected<U, E> * out, F f )
+{
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        if ( first[i].has_value() ) out[i] = expected<U, E>( f( *first[i] ) );
+        else                        out[i] = expected<U, E>( unexpect, first[i].error() );
+    }
+}
+
+/// append the indices of the elements that hold a value to values and those of
+/// the elements that hold an error to errors, in order:
+
+template< typename T, typename E >
+void partition_indices( expected<T, E> const * first, std::size_t n, std::vector<std::size_t> & values, std::vector<std::size_t> & errors, bulk_isa isa = detected_bulk_isa() )
+{
+    const std::size_t count = count_values( first, n, isa );
+    const std::size_t v0    = values.size();
+    const std::size_t e0    = errors.size();
+
+    // reserve first, so that the vectors remain unchanged if that throws:
+
+    values.reserve( v0 + count + 1 );
+    errors.reserve( e0 + n - count + 1 );
+    values.resize( v0 + count + 1 );
+    errors.resize( e0 + n - count + 1 );
+
+    detail::partition_indices_op<T, E> op = { first, n, values.data() + v0, errors.data() + e0 };
+
+    std::size_t i = detail::run_bulk<T, E>( op, isa );
+
+    for ( ; i < n; ++i )
+        op.put( i, first[i].has_value() );
+
+    values.resize( v0 + count );
+    errors.resize( e0 + n - count );
+}
+
+} // namespace expected_lite
+
+using expected_lite::bulk_isa;
+using expected_lite::detected_bulk_isa;
+using expected_lite::count_values;
+using expected_lite::find_error;
+using expected_lite::values_or;
+using expected_lite::transform_values;
+using expected_lite::partition_indices;
+
+} // namespace nonstd
+
+#undef nsel_BULK_TARGET_AVX2
+#undef nsel_BULK_TARGET_AVX512
+
+#endif // NONSTD_EXPECTED_LITE_BULK_HPP
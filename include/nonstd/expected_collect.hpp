@@ -0,0 +1,388 @@
+// This version targets C++11 and later.
+//
+// Copyright (C) 2016-2025 Martin Moene.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// expected lite collect: turn a range of expected<T,E> into an
+// expected<std::vector<T>,E> with the values in order, or the first error, e.g.
+//
+//   std::vector< nonstd::expected<int, std::errc> > parsed = ...;
+//
+//   nonstd::expected< std::vector<int>, std::errc > all = nonstd::sequence( parsed );
+//
+// With nsel_CONFIG_PARALLEL_COLLECT, also collect() under a C++17 execution
+// policy and transform_collect(), which applies a function on several threads.
+// Kept apart from expected.hpp, so that only its users include <vector> and,
+// with parallel collect, <thread> and <execution>.
+
+#ifndef NONSTD_EXPECTED_LITE_COLLECT_HPP
+#define NONSTD_EXPECTED_LITE_COLLECT_HPP
+
+#include "expected.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Control presence of the multi-threaded transform_collect() and of collect() with an execution policy, default off:
+
+#ifndef  nsel_CONFIG_PARALLEL_COLLECT
+# define nsel_CONFIG_PARALLEL_COLLECT  0
+#endif
+
+#if nsel_CONFIG_PARALLEL_COLLECT
+# include <algorithm>
+# include <atomic>
+# include <exception>
+# include <system_error>
+# include <thread>
+# if nsel_CPP17_OR_GREATER && defined( __has_include )
+#  if __has_include( <execution> )
+#   include <execution>
+#  endif
+# endif
+#endif
+
+// Presence of collect() with a C++17 execution policy:
+
+#if nsel_CONFIG_PARALLEL_COLLECT && defined( __cpp_lib_execution )
+# define nsel_HAVE_EXECUTION_POLICY  1
+#else
+# define nsel_HAVE_EXECUTION_POLICY  0
+#endif
+
+#if nsel_USES_STD_EXPECTED
+# define nsel_COLLECT_UNLIKELY( expr )  ( expr )
+#else
+# define nsel_COLLECT_UNLIKELY( expr )  nsel_UNLIKELY( expr )
+#endif
+
+namespace nonstd {
+namespace expected_lite {
+
+// collect, sequence: turn a range of expected<T,E> into expected<std::vector<T>,E>:
+
+namespace detail {
+
+template< typename T >
+using collect_decay_t = typename std::remove_cv< typename std::remove_reference<T>::type >::type;
+
+template< typename Iter >
+struct collect_result
+{
+    using element_type = collect_decay_t< decltype( *std::declval<Iter>() ) >;
+    using type         = expected< std::vector< typename element_type::value_type >, typename element_type::error_type >;
+};
+
+template< typename T, typename Iter >
+void reserve_for( std::vector<T> &, Iter, Iter, std::input_iterator_tag )
+{
+}
+
+template< typename T, typename Iter >
+void reserve_for( std::vector<T> & values, Iter first, Iter last, std::forward_iterator_tag )
+{
+    values.reserve( static_cast<std::size_t>( std::distance( first, last ) ) );
+}
+
+} // namespace detail
+
+/// the values in order, or the first error; the elements of a std::move_iterator range are moved from.
+
+template< typename InputIt >
+auto collect( InputIt first, InputIt last ) -> typename detail::collect_result<InputIt>::type
+{
+    using result_type = typename detail::collect_result<InputIt>::type;
+
+    typename result_type::value_type values;
+    detail::reserve_for( values, first, last, typename std::iterator_traits<InputIt>::iterator_category() );
+
+    for ( ; first != last; ++first )
+    {
+        auto && element = *first;
+
+        if ( nsel_COLLECT_UNLIKELY( ! element.has_value() ) )
+        {
+            return result_type( unexpect, std::forward<decltype(element)>( element ).error() );
+        }
+        values.push_back( *std::forward<decltype(element)>( element ) );
+    }
+    return result_type( in_place, std::move( values ) );
+}
+
+namespace detail {
+
+template< typename Range >
+using range_iterator_t = decltype( std::begin( std::declval<Range &>() ) );
+
+template< typename Range >
+auto sequence( Range & range, std::true_type /*lvalue*/ ) -> typename collect_result< range_iterator_t<Range> >::type
+{
+    return collect( std::begin( range ), std::end( range ) );
+}
+
+template< typename Range >
+auto sequence( Range & range, std::false_type /*rvalue*/ ) -> typename collect_result< range_iterator_t<Range> >::type
+{
+    return collect( std::make_move_iterator( std::begin( range ) ), std::make_move_iterator( std::end( range ) ) );
+}
+
+} // namespace detail
+
+/// collect() over a range; the elements of an rvalue range are moved from.
+
+template< typename Range >
+auto sequence( Range && range ) -> typename detail::collect_result< detail::range_iterator_t<Range> >::type
+{
+    return detail::sequence( range, std::is_lvalue_reference<Range>() );
+}
+
+#if nsel_HAVE_EXECUTION_POLICY
+
+namespace detail {
+
+template< typename Result, typename ExecutionPolicy, typename ForwardIt >
+Result collect_values( ExecutionPolicy && policy, ForwardIt first, ForwardIt last, std::true_type /*default constructible*/ )
+{
+    using reference = decltype( *first );
+
+    typename Result::value_type values( static_cast<std::size_t>( std::distance( first, last ) ) );
+
+    std::transform( std::forward<ExecutionPolicy>( policy ), first, last, values.begin(),
+        []( reference element ) { return *std::forward<reference>( element ); } );
+
+    return Result( in_place, std::move( values ) );
+}
+
+template< typename Result, typename ExecutionPolicy, typename ForwardIt >
+Result collect_values( ExecutionPolicy &&, ForwardIt first, ForwardIt last, std::false_type /*default constructible*/ )
+{
+    return collect( first, last );
+}
+
+} // namespace detail
+
+/// collect() that searches for the first error and, if the value type is default
+/// constructible, also transfers the values under the given execution policy.
+
+template< typename ExecutionPolicy, typename ForwardIt
+    , typename = typename std::enable_if< std::is_execution_policy< detail::collect_decay_t<ExecutionPolicy> >::value >::type
+>
+auto collect( ExecutionPolicy && policy, ForwardIt first, ForwardIt last ) -> typename detail::collect_result<ForwardIt>::type
+{
+    using result_type = typename detail::collect_result<ForwardIt>::type;
+    using reference   = decltype( *first );
+
+    const ForwardIt failed = std::find_if( policy, first, last,
+        []( reference element ) { return ! element.has_value(); } );
+
+    if ( failed != last )
+    {
+        return result_type( unexpect, std::forward<reference>( *failed ).error() );
+    }
+
+    return detail::collect_values<result_type>( std::forward<ExecutionPolicy>( policy ), first, last,
+        std::is_default_constructible< typename result_type::value_type::value_type >() );
+}
+
+#endif // nsel_HAVE_EXECUTION_POLICY
+
+#if nsel_CONFIG_PARALLEL_COLLECT
+
+// transform_collect: apply f to the elements of a random access range on several threads:
+
+namespace detail {
+
+template< typename RandomIt, typename F >
+struct transform_collect_result
+{
+    using element_type = collect_decay_t< decltype( std::declval<F &>()( *std::declval<RandomIt>() ) ) >;
+    using type         = expected< std::vector< typename element_type::value_type >, typename element_type::error_type >;
+};
+
+// lowest index of a failed element, seen by all chunks:
+
+class first_failure
+{
+public:
+    explicit first_failure( std::size_t none ) noexcept
+        : m_index( none )
+    {}
+
+    bool precedes( std::size_t index ) const noexcept
+    {
+        return m_index.load( std::memory_order_relaxed ) < index;
+    }
+
+    void record( std::size_t index ) noexcept
+    {
+        std::size_t current = m_index.load( std::memory_order_relaxed );
+
+        while ( index < current && ! m_index.compare_exchange_weak( current, index, std::memory_order_relaxed ) )
+        {
+        }
+    }
+
+private:
+    std::atomic<std::size_t> m_index;
+};
+
+// a chunk stops at its first error, or when an element before it failed:
+
+template< typename Result, typename RandomIt, typename F >
+Result transform_collect_chunk( RandomIt first, std::size_t begin, std::size_t end, F & f, first_failure & failure )
+{
+    typename Result::value_type values;
+    values.reserve( end - begin );
+
+    for ( std::size_t i = begin; i != end; ++i )
+    {
+        if ( failure.precedes( i ) )
+        {
+            break;
+        }
+
+        auto && r = f( first[ static_cast<typename std::iterator_traits<RandomIt>::difference_type>( i ) ] );
+
+        if ( nsel_COLLECT_UNLIKELY( ! r.has_value() ) )
+        {
+            failure.record( i );
+            return Result( unexpect, std::forward<decltype(r)>( r ).error() );
+        }
+        values.push_back( *std::forward<decltype(r)>( r ) );
+    }
+    return Result( in_place, std::move( values ) );
+}
+
+inline std::size_t transform_collect_threads( std::size_t size, std::size_t max_threads )
+{
+    const std::size_t min_chunk = 1024;
+
+    if ( max_threads == 0 )
+    {
+        const std::size_t hardware = std::thread::hardware_concurrency();
+
+        max_threads = ( std::min )( hardware > 0 ? hardware : 1, size / min_chunk );
+    }
+    return ( std::max )( std::size_t( 1 ), ( std::min )( max_threads, size ) );
+}
+
+} // namespace detail
+
+/// the results of f applied to each element in order, or the first error of f; the range
+/// is split into one chunk per thread and chunks stop as soon as an earlier element failed.
+/// f must be safe to call concurrently; max_threads 0 selects a number based on the
+/// hardware concurrency and the size of the range.
+
+template< typename RandomIt, typename F >
+auto transform_collect( RandomIt first, RandomIt last, F f, std::size_t max_threads = 0 )
+    -> typename detail::transform_collect_result<RandomIt, F>::type
+{
+    using result_type = typename detail::transform_collect_result<RandomIt, F>::type;
+
+    const std::size_t size    = static_cast<std::size_t>( last - first );
+    const std::size_t threads = detail::transform_collect_threads( size, max_threads );
+    const std::size_t chunk   = ( size + threads - 1 ) / threads;
+
+    std::vector< result_type > chunks( threads );
+    detail::first_failure failure( size );
+
+#if nsel_CONFIG_NO_EXCEPTIONS
+    auto run = [&]( std::size_t k )
+    {
+        chunks[k] = detail::transform_collect_chunk<result_type>(
+            first, ( std::min )( size, k * chunk ), ( std::min )( size, ( k + 1 ) * chunk ), f, failure );
+    };
+#else
+    std::vector< std::exception_ptr > exceptions( threads );
+
+    auto run = [&]( std::size_t k )
+    {
+        try
+        {
+            chunks[k] = detail::transform_collect_chunk<result_type>(
+                first, ( std::min )( size, k * chunk ), ( std::min )( size, ( k + 1 ) * chunk ), f, failure );
+        }
+        catch ( ... )
+        {
+            failure.record( k * chunk );
+            exceptions[k] = std::current_exception();
+        }
+    };
+#endif
+
+    std::vector< std::thread > workers;
+    workers.reserve( threads - 1 );
+
+    for ( std::size_t k = 1; k < threads; ++k )
+    {
+#if nsel_CONFIG_NO_EXCEPTIONS
+        workers.emplace_back( run, k );
+#else
+        try
+        {
+            workers.emplace_back( run, k );
+        }
+        catch ( std::system_error const & )
+        {
+            run( k );
+        }
+#endif
+    }
+
+    run( 0 );
+
+    for ( auto & worker : workers )
+    {
+        worker.join();
+    }
+
+    typename result_type::value_type values;
+    values.reserve( size );
+
+    for ( std::size_t k = 0; k < threads; ++k )
+    {
+#if !nsel_CONFIG_NO_EXCEPTIONS
+        if ( exceptions[k] )
+        {
+            std::rethrow_exception( exceptions[k] );
+        }
+#endif
+        if ( ! chunks[k].has_value() )
+        {
+            return result_type( unexpect, std::move( chunks[k] ).error() );
+        }
+        values.insert( values.end(), std::make_move_iterator( chunks[k]->begin() ), std::make_move_iterator( chunks[k]->end() ) );
+    }
+    return result_type( in_place, std::move( values ) );
+}
+
+/// transform_collect() over a random access range.
+
+template< typename Range, typename F >
+auto transform_collect( Range && range, F f, std::size_t max_threads = 0 )
+    -> typename detail::transform_collect_result< detail::range_iterator_t<Range>, F >::type
+{
+    return transform_collect( std::begin( range ), std::end( range ), std::move( f ), max_threads );
+}
+
+#endif // nsel_CONFIG_PARALLEL_COLLECT
+
+} // namespace expected_lite
+
+using expected_lite::collect;
+using expected_lite::sequence;
+
+#if nsel_CONFIG_PARALLEL_COLLECT
+using expected_lite::transform_collect;
+#endif
+
+} // namespace nonstd
+
+#undef nsel_COLLECT_UNLIKELY
+
+#endif // NONSTD_EXPECTED_LITE_COLLECT_HPP
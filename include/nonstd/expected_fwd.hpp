@@ -0,0 +1,149 @@
+// This version targets C++11 and later.
+//
+// Copyright (C) 2016-2025 Martin Moene.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// expected lite forward declarations: expected, unexpected_type, unexpected,
+// bad_expected_access and unexpect_t, for code that only names these types,
+// e.g. in function declarations. Include expected.hpp to use them.
+//
+// Configure expected_fwd.hpp in the same way as expected.hpp; it honours the
+// tweak header and nsel_CONFIG_SELECT_EXPECTED, nsel_P0323R and nsel_CPLUSPLUS.
+
+#ifndef NONSTD_EXPECTED_LITE_FWD_HPP
+#define NONSTD_EXPECTED_LITE_FWD_HPP
+
+// Nothing to declare once expected.hpp is included:
+
+#ifndef NONSTD_EXPECTED_LITE_HPP
+
+// Note: the following definitions must be the same as in expected.hpp:
+
+#define nsel_EXPECTED_DEFAULT  0
+#define nsel_EXPECTED_NONSTD   1
+#define nsel_EXPECTED_STD      2
+
+// tweak header support:
+
+#ifdef __has_include
+# if __has_include(<nonstd/expected.tweak.hpp>)
+#  include <nonstd/expected.tweak.hpp>
+# endif
+#define expected_HAVE_TWEAK_HEADER  1
+#else
+#define expected_HAVE_TWEAK_HEADER  0
+#endif
+
+// expected selection and configuration:
+
+#if !defined( nsel_CONFIG_SELECT_EXPECTED )
+# define nsel_CONFIG_SELECT_EXPECTED  ( nsel_HAVE_STD_EXPECTED ? nsel_EXPECTED_STD : nsel_EXPECTED_NONSTD )
+#endif
+
+#ifndef  nsel_P0323R
+# define nsel_P0323R  7
+#endif
+
+// C++ language version detection (C++23 is speculative):
+// Note: VC14.0/1900 (VS2015) lacks too much from C++14.
+
+#ifndef   nsel_CPLUSPLUS
+# if defined(_MSVC_LANG ) && !defined(__clang__)
+#  define nsel_CPLUSPLUS  (_MSC_VER == 1900 ? 201103L : _MSVC_LANG )
+# else
+#  define nsel_CPLUSPLUS  __cplusplus
+# endif
+#endif
+
+#define nsel_CPP17_OR_GREATER  ( nsel_CPLUSPLUS >= 201703L )
+#define nsel_CPP23_OR_GREATER  ( nsel_CPLUSPLUS >= 202300L )
+
+// Use C++23 std::expected if available and requested:
+
+#if nsel_CPP23_OR_GREATER && defined(__has_include )
+# if __has_include( <expected> )
+#  define nsel_HAVE_STD_EXPECTED  1
+# else
+#  define nsel_HAVE_STD_EXPECTED  0
+# endif
+#else
+# define  nsel_HAVE_STD_EXPECTED  0
+#endif
+
+#define  nsel_USES_STD_EXPECTED  ( (nsel_CONFIG_SELECT_EXPECTED == nsel_EXPECTED_STD) || ((nsel_CONFIG_SELECT_EXPECTED == nsel_EXPECTED_DEFAULT) && nsel_HAVE_STD_EXPECTED) )
+
+#if defined(_MSC_VER) && !defined(__clang__)
+# define nsel_COMPILER_MSVC_VER      (_MSC_VER )
+# define nsel_COMPILER_MSVC_VERSION  (_MSC_VER / 10 - 10 * ( 5 + (_MSC_VER < 1900)) )
+#else
+# define nsel_COMPILER_MSVC_VER      0
+# define nsel_COMPILER_MSVC_VERSION  0
+#endif
+
+#if nsel_USES_STD_EXPECTED
+
+// std::expected can't be declared without its header:
+
+#include <expected>
+
+namespace nonstd {
+
+    using std::expected;
+    using std::unexpected;
+    using std::bad_expected_access;
+    using std::unexpect_t;
+
+    template< typename E >
+    using unexpected_type = unexpected<E>;
+
+} // namespace nonstd
+
+#else // nsel_USES_STD_EXPECTED
+
+#if nsel_P0323R <= 2
+# include <exception>
+#endif
+
+namespace nonstd {
+namespace expected_lite {
+
+#if nsel_P0323R <= 2
+template< typename T, typename E = std::exception_ptr >
+class expected;
+
+template< typename E = std::exception_ptr >
+class unexpected_type;
+#else
+template< typename T, typename E >
+class expected;
+
+template< typename E >
+class unexpected_type;
+#endif // nsel_P0323R
+
+template< typename E >
+class bad_expected_access;
+
+struct unexpect_t;
+
+} // namespace expected_lite
+
+using expected_lite::expected;
+using expected_lite::unexpected_type;
+using expected_lite::bad_expected_access;
+using expected_lite::unexpect_t;
+
+#if nsel_CPP17_OR_GREATER || nsel_COMPILER_MSVC_VERSION > 141
+template< typename E >
+using unexpected = unexpected_type<E>;
+#endif
+
+} // namespace nonstd
+
+#endif // nsel_USES_STD_EXPECTED
+
+#endif // NONSTD_EXPECTED_LITE_HPP
+
+#endif // NONSTD_EXPECTED_LITE_FWD_HPP
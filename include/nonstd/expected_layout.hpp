@@ -0,0 +1,178 @@
+// This version targets C++11 and later.
+//
+// Copyright (C) 2016-2025 Martin Moene.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// expected lite layout report: size, alignment, placement of value, error and
+// discriminant, and padding of expected<T,E>, at compile time, e.g.
+//
+//   static_assert( nonstd::layout_report<int, std::errc>().size == 8, "" );
+//   std::cout << nonstd::layout_report<int, std::errc>() << "\n";
+//
+// prints: size 8, align 4: value 4 bytes at 0, error 4 bytes at 0, discriminant flag 1 byte at 4, padding 3
+
+#ifndef NONSTD_EXPECTED_LITE_LAYOUT_HPP
+#define NONSTD_EXPECTED_LITE_LAYOUT_HPP
+
+#include "expected.hpp"
+
+#include <cstddef>
+#include <ostream>
+
+namespace nonstd {
+namespace expected_lite {
+
+/// where expected<T,E> keeps has_value():
+
+enum class layout_discriminant
+{
+    flag,               // a bool after the union of value and error
+    niche_in_value,     // the niche of the value, see niche_traits
+    niche_in_error,     // the niche of the error, see niche_traits
+    unknown             // std::expected
+};
+
+/// layout of expected<T,E>; offsets and sizes in bytes.
+///
+/// The padding counts the bytes of expected<T,E> that neither the value, nor the
+/// error, nor the discriminant occupy; it does not include padding inside T or E.
+
+struct expected_layout
+{
+    std::size_t         size;
+    std::size_t         align;
+    std::size_t         value_size;         // 0 for void
+    std::size_t         value_offset;
+    std::size_t         error_size;
+    std::size_t         error_offset;
+    layout_discriminant discriminant;
+    std::size_t         discriminant_size;
+    std::size_t         discriminant_offset;
+    std::size_t         padding;
+};
+
+namespace detail {
+
+#if nsel_USES_STD_EXPECTED
+
+template< typename T > struct layout_size_of       : std::integral_constant< std::size_t, sizeof(T) > {};
+template<>             struct layout_size_of<void> : std::integral_constant< std::size_t, 0 > {};
+
+template< typename T, typename E >
+struct layout_of
+{
+    static constexpr expected_layout get()
+    {
+        return { sizeof( expected<T, E> ), alignof( expected<T, E> ), layout_size_of<T>::value, 0, sizeof( E ), 0, layout_discriminant::unknown, 0, 0, 0 };
+    }
+};
+
+#else // nsel_USES_STD_EXPECTED
+
+constexpr std::size_t extent_of( std::size_t size, std::size_t offset )
+{
+    return size ? offset + size : 0;
+}
+
+template< typename T, typename E >
+constexpr expected_layout make_layout(
+    std::size_t value_offset, std::size_t error_offset, layout_discriminant discriminant, std::size_t discriminant_size, std::size_t discriminant_offset )
+{
+    return {
+        sizeof( expected<T, E> ), alignof( expected<T, E> )
+        , size_of<T>::value, value_offset
+        , sizeof( E ), error_offset
+        , discriminant, discriminant_size, discriminant_offset
+        , sizeof( expected<T, E> ) - max_of( max_of( extent_of( size_of<T>::value, value_offset ), extent_of( sizeof( E ), error_offset ) ), extent_of( discriminant_size, discriminant_offset ) )
+    };
+}
+
+template< typename T, typename E, niche_kind kind = niche_layout<T, E>::kind >
+struct layout_of;
+
+// storage_t_union: union of value and error, followed by bool m_has_value:
+
+template< typename T, typename E >
+struct layout_of< T, E, niche_none >
+{
+    static constexpr expected_layout get()
+    {
+        return make_layout<T, E>( 0, 0, layout_discriminant::flag, sizeof( bool )
+            , align_up( max_of( max_of( size_of<T>::value, sizeof( E ) ), 1 ), max_of( align_of<T>::value, alignof( E ) ) ) );
+    }
+};
+
+// storage_t_niche: value at 0, error beside the niche of the value:
+
+template< typename T, typename E >
+struct layout_of< T, E, niche_in_value >
+{
+    static constexpr expected_layout get()
+    {
+        return make_layout<T, E>( 0, niche_layout<T, E>::error_offset, layout_discriminant::niche_in_value
+            , niche_traits<T>::niche_size, niche_traits<T>::niche_offset );
+    }
+};
+
+// storage_t_niche: error at 0, value beside the niche of the error:
+
+template< typename T, typename E >
+struct layout_of< T, E, niche_in_error >
+{
+    static constexpr expected_layout get()
+    {
+        return make_layout<T, E>( niche_layout<T, E>::value_offset, 0, layout_discriminant::niche_in_error
+            , niche_traits<E>::niche_size, niche_traits<E>::niche_offset );
+    }
+};
+
+#endif // nsel_USES_STD_EXPECTED
+
+} // namespace detail
+
+/// the layout of expected<T,E>, at compile time:
+
+template< typename T, typename E >
+constexpr expected_layout layout_report() noexcept
+{
+    return detail::layout_of<T, E>::get();
+}
+
+inline char const * to_string( layout_discriminant d )
+{
+    return d == layout_discriminant::flag           ? "flag"
+         : d == layout_discriminant::niche_in_value ? "niche in value"
+         : d == layout_discriminant::niche_in_error ? "niche in error"
+         :                                            "unknown";
+}
+
+/// print layout as 'size 8, align 4: value 4 bytes at 0, error 4 bytes at 0, discriminant flag 1 byte at 4, padding 3':
+
+inline std::ostream & operator<<( std::ostream & os, expected_layout const & layout )
+{
+    const auto bytes = []( std::size_t n ) { return n == 1 ? " byte at " : " bytes at "; };
+
+    os << "size " << layout.size << ", align " << layout.align << ": ";
+
+    if ( layout.value_size )
+        os << "value " << layout.value_size << bytes( layout.value_size ) << layout.value_offset << ", ";
+
+    os << "error " << layout.error_size << bytes( layout.error_size ) << layout.error_offset << ", discriminant " << to_string( layout.discriminant );
+
+    if ( layout.discriminant != layout_discriminant::unknown )
+        os << " " << layout.discriminant_size << bytes( layout.discriminant_size ) << layout.discriminant_offset << ", padding " << layout.padding;
+
+    return os;
+}
+
+} // namespace expected_lite
+
+using expected_lite::layout_discriminant;
+using expected_lite::expected_layout;
+using expected_lite::layout_report;
+
+} // namespace nonstd
+
+#endif // NONSTD_EXPECTED_LITE_LAYOUT_HPP
@@ -0,0 +1,509 @@
+// This version targets C++11 and later.
+//
+// Copyright (C) 2016-2025 Martin Moene.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// expected lite vector: a sequence of results like expected<T,E>, kept as a
+// structure of arrays: the values in one array, the errors in another, both in
+// order, and a bitmap of has_value(), e.g.
+//
+//   nonstd::expected_vector<int, std::errc> results;
+//
+//   results.push_back( 42 );
+//   results.push_back( nonstd::make_unexpected( std::errc::invalid_argument ) );
+//
+//   for ( int x : results.values() ) ...
+//
+// Element i is a value if bit i of the bitmap is set. The number of values
+// before element i gives the position of its value or its error: a count per
+// block of 64 elements plus the popcount of the bits before i in its block.
+
+#ifndef NONSTD_EXPECTED_LITE_VECTOR_HPP
+#define NONSTD_EXPECTED_LITE_VECTOR_HPP
+
+#include "expected.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if nsel_USES_STD_EXPECTED
+# define nsel_VECTOR_ASSERT( expr )  assert( expr )
+#else
+# define nsel_VECTOR_ASSERT( expr )  nsel_ASSERT( expr )
+#endif
+
+namespace nonstd {
+namespace expected_lite {
+
+namespace detail {
+
+/// the number of bits set:
+
+inline std::size_t popcount64( std::uint64_t x ) noexcept
+{
+#if defined( __GNUC__ )
+    return static_cast<std::size_t>( __builtin_popcountll( x ) );
+#else
+    x = x - ( ( x >> 1 ) & 0x5555555555555555u );
+    x = ( x & 0x3333333333333333u ) + ( ( x >> 2 ) & 0x3333333333333333u );
+    x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0fu;
+    return static_cast<std::size_t>( ( x * 0x0101010101010101u ) >> 56 );
+#endif
+}
+
+/// the number of zero bits below the lowest bit set, x != 0:
+
+inline std::size_t countr_zero64( std::uint64_t x ) noexcept
+{
+#if defined( __GNUC__ )
+    return static_cast<std::size_t>( __builtin_ctzll( x ) );
+#else
+    return popcount64( ( x & ( ~x + 1 ) ) - 1 );
+#endif
+}
+
+} // namespace detail
+
+/// view of an element of expected_vector, like expected<T&,E&>; T and E are
+/// const for a view of a const element:
+
+template< typename T, typename E >
+class expected_vector_reference
+{
+public:
+    using value_type = T;
+    using error_type = E;
+
+    expected_vector_reference( value_type * value, error_type * error ) noexcept
+        : m_value( value )
+        , m_error( error )
+    {}
+
+    // view of a non-const element as view of a const element:
+
+    template< typename U, typename G
+        , typename = typename std::enable_if< std::is_convertible<U *, T *>::value && std::is_convertible<G *, E *>::value >::type
+    >
+    expected_vector_reference( expected_vector_reference<U, G> const & other ) noexcept
+        : m_value( other.has_value() ? other.operator->() : nullptr )
+        , m_error( other.has_value() ? nullptr : std::addressof( other.error() ) )
+    {}
+
+    bool has_value() const noexcept
+    {
+        return m_value != nullptr;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    value_type * operator->() const
+    {
+        return nsel_VECTOR_ASSERT( has_value() ), m_value;
+    }
+
+    value_type & operator*() const
+    {
+        return nsel_VECTOR_ASSERT( has_value() ), *m_value;
+    }
+
+    value_type & value() const
+    {
+        if ( ! has_value() )
+        {
+#if nsel_USES_STD_EXPECTED
+            throw bad_expected_access< typename std::remove_const<E>::type >( *m_error );
+#else
+            detail::report_bad_expected_access( *m_error );
+#endif
+        }
+        return *m_value;
+    }
+
+    error_type & error() const
+    {
+        return nsel_VECTOR_ASSERT( ! has_value() ), *m_error;
+    }
+
+    template< typename U >
+    typename std::remove_const<T>::type value_or( U && v ) const
+    {
+        return has_value() ? *m_value : static_cast<typename std::remove_const<T>::type>( std::forward<U>( v ) );
+    }
+
+    /// copy of the element:
+
+    operator expected< typename std::remove_const<T>::type, typename std::remove_const<E>::type >() const
+    {
+        using result = expected< typename std::remove_const<T>::type, typename std::remove_const<E>::type >;
+
+        return has_value() ? result( *m_value ) : result( unexpect, *m_error );
+    }
+
+private:
+    value_type * m_value;
+    error_type * m_error;
+};
+
+namespace detail {
+
+/// iterator over the elements of expected_vector, which yields views:
+
+template< typename Vector, typename Reference >
+class expected_vector_iterator
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Reference;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = Reference;
+
+    expected_vector_iterator( Vector * vector, std::size_t index ) noexcept
+        : m_vector( vector )
+        , m_index( index )
+    {}
+
+    template< typename V, typename R
+        , typename = typename std::enable_if< std::is_convertible<V *, Vector *>::value >::type
+    >
+    expected_vector_iterator( expected_vector_iterator<V, R> const & other ) noexcept
+        : m_vector( other.m_vector )
+        , m_index( other.m_index )
+    {}
+
+    reference operator*() const
+    {
+        return ( *m_vector )[ m_index ];
+    }
+
+    expected_vector_iterator & operator++() noexcept
+    {
+        ++m_index;
+        return *this;
+    }
+
+    expected_vector_iterator operator++( int ) noexcept
+    {
+        expected_vector_iterator result( *this );
+        ++m_index;
+        return result;
+    }
+
+    std::size_t index() const noexcept
+    {
+        return m_index;
+    }
+
+    friend bool operator==( expected_vector_iterator const & a, expected_vector_iterator const & b ) noexcept
+    {
+        return a.m_index == b.m_index;
+    }
+
+    friend bool operator!=( expected_vector_iterator const & a, expected_vector_iterator const & b ) noexcept
+    {
+        return a.m_index != b.m_index;
+    }
+
+private:
+    template< typename, typename > friend class expected_vector_iterator;
+
+    Vector *    m_vector;
+    std::size_t m_index;
+};
+
+/// the values or the errors of expected_vector:
+
+template< typename Iterator >
+class expected_vector_range
+{
+public:
+    expected_vector_range( Iterator first, Iterator last )
+        : m_first( first )
+        , m_last( last )
+    {}
+
+    Iterator begin() const { return m_first; }
+    Iterator end()   const { return m_last; }
+
+    std::size_t size() const { return static_cast<std::size_t>( std::distance( m_first, m_last ) ); }
+    bool       empty() const { return m_first == m_last; }
+
+private:
+    Iterator m_first;
+    Iterator m_last;
+};
+
+} // namespace detail
+
+/// sequence of results like expected<T,E>, values and errors in arrays of their
+/// own and has_value() in a bitmap; elements are appended, not inserted.
+///
+/// Adding an element gives the strong exception guarantee. The views and
+/// the iterators of the values and the errors are invalidated as those of
+/// std::vector<T> and std::vector<E> are.
+
+template< typename T, typename E >
+class expected_vector
+{
+    static_assert( ! std::is_void<T>::value, "expected_vector<T,E>: T must not be void" );
+    static_assert( ! std::is_same<T, bool>::value && ! std::is_same<E, bool>::value
+        , "expected_vector<T,E>: T and E must not be bool, as std::vector<bool> provides no references" );
+
+public:
+    using value_type      = T;
+    using error_type      = E;
+    using size_type       = std::size_t;
+    using reference       = expected_vector_reference<T, E>;
+    using const_reference = expected_vector_reference<T const, E const>;
+    using iterator        = detail::expected_vector_iterator<expected_vector, reference>;
+    using const_iterator  = detail::expected_vector_iterator<expected_vector const, const_reference>;
+    using value_range       = detail::expected_vector_range<typename std::vector<T>::iterator>;
+    using const_value_range = detail::expected_vector_range<typename std::vector<T>::const_iterator>;
+    using error_range       = detail::expected_vector_range<typename std::vector<E>::iterator>;
+    using const_error_range = detail::expected_vector_range<typename std::vector<E>::const_iterator>;
+
+    // capacity:
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /// reserve room for n elements, of which all may be values:
+
+    void reserve( size_type n )
+    {
+        m_values.reserve( n );
+        m_blocks.reserve( ( n + block_bits - 1 ) / block_bits );
+    }
+
+    void clear() noexcept
+    {
+        m_values.clear();
+        m_errors.clear();
+        m_blocks.clear();
+        m_size = 0;
+    }
+
+    // modifiers:
+
+    void push_back( expected<T, E> const & x )
+    {
+        if ( x.has_value() ) emplace_back( *x );
+        else                 emplace_error_back( x.error() );
+    }
+
+    void push_back( expected<T, E> && x )
+    {
+        if ( x.has_value() ) emplace_back( std::move( *x ) );
+        else                 emplace_error_back( std::move( x.error() ) );
+    }
+
+    void push_back( T const & value )
+    {
+        emplace_back( value );
+    }
+
+    void push_back( T && value )
+    {
+        emplace_back( std::move( value ) );
+    }
+
+    void push_back( unexpected_type<E> const & error )
+    {
+        emplace_error_back( error.error() );
+    }
+
+    void push_back( unexpected_type<E> && error )
+    {
+        emplace_error_back( std::move( error.error() ) );
+    }
+
+    template< typename... Args >
+    reference emplace_back( Args &&... args )
+    {
+        add_block();
+        m_values.emplace_back( std::forward<Args>( args )... );
+        m_blocks.back().bits |= std::uint64_t( 1 ) << ( m_size % block_bits );
+        ++m_size;
+
+        return reference( &m_values.back(), nullptr );
+    }
+
+    template< typename... Args >
+    reference emplace_error_back( Args &&... args )
+    {
+        add_block();
+        m_errors.emplace_back( std::forward<Args>( args )... );
+        ++m_size;
+
+        return reference( nullptr, &m_errors.back() );
+    }
+
+    // element access:
+
+    reference operator[]( size_type i )
+    {
+        nsel_VECTOR_ASSERT( i < m_size );
+
+        const size_type values = values_before( i );
+
+        return has_value( i ) ? reference( &m_values[ values ], nullptr ) : reference( nullptr, &m_errors[ i - values ] );
+    }
+
+    const_reference operator[]( size_type i ) const
+    {
+        nsel_VECTOR_ASSERT( i < m_size );
+
+        const size_type values = values_before( i );
+
+        return has_value( i ) ? const_reference( &m_values[ values ], nullptr ) : const_reference( nullptr, &m_errors[ i - values ] );
+    }
+
+    reference at( size_type i )
+    {
+        return check( i ), ( *this )[ i ];
+    }
+
+    const_reference at( size_type i ) const
+    {
+        return check( i ), ( *this )[ i ];
+    }
+
+    bool has_value( size_type i ) const
+    {
+        return nsel_VECTOR_ASSERT( i < m_size ), ( m_blocks[ i / block_bits ].bits >> ( i % block_bits ) ) & 1u;
+    }
+
+    // iteration over all elements, over the values and over the errors:
+
+    iterator       begin()        noexcept { return iterator( this, 0 ); }
+    iterator       end()          noexcept { return iterator( this, m_size ); }
+    const_iterator begin()  const noexcept { return const_iterator( this, 0 ); }
+    const_iterator end()    const noexcept { return const_iterator( this, m_size ); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+    value_range       values()       { return value_range      ( m_values.begin(), m_values.end() ); }
+    const_value_range values() const { return const_value_range( m_values.begin(), m_values.end() ); }
+    error_range       errors()       { return error_range      ( m_errors.begin(), m_errors.end() ); }
+    const_error_range errors() const { return const_error_range( m_errors.begin(), m_errors.end() ); }
+
+    // counts and search:
+
+    size_type count_values() const noexcept
+    {
+        return m_values.size();
+    }
+
+    size_type count_errors() const noexcept
+    {
+        return m_errors.size();
+    }
+
+    /// the number of values among the elements [first, last):
+
+    size_type count_values( size_type first, size_type last ) const
+    {
+        return nsel_VECTOR_ASSERT( first <= last && last <= m_size ), values_before( last ) - values_before( first );
+    }
+
+    /// the index of the first error at or after from, size() if there is none:
+
+    size_type first_error( size_type from = 0 ) const
+    {
+        if ( m_errors.empty() || from >= m_size )
+            return m_size;
+
+        for ( size_type block = from / block_bits; block < m_blocks.size(); ++block )
+        {
+            std::uint64_t missing = ~m_blocks[ block ].bits;
+
+            if ( block == from / block_bits )
+                missing &= ~std::uint64_t( 0 ) << ( from % block_bits );
+
+            if ( missing )
+            {
+                const size_type i = block * block_bits + detail::countr_zero64( missing );
+                return i < m_size ? i : m_size;
+            }
+        }
+        return m_size;
+    }
+
+private:
+    static const size_type block_bits = 64;
+
+    // has_value() of 64 elements and the number of values before them:
+
+    struct block
+    {
+        std::uint64_t bits;
+        size_type     values_before;
+    };
+
+    // start a new block for element m_size if needed; a block that remains
+    // after the construction of the element threw is used next time:
+
+    void add_block()
+    {
+        if ( m_size == m_blocks.size() * block_bits )
+            m_blocks.push_back( block{ 0, m_values.size() } );
+    }
+
+    size_type values_before( size_type i ) const
+    {
+        if ( i == m_size )
+            return m_values.size();
+
+        block const & b = m_blocks[ i / block_bits ];
+
+        return b.values_before + detail::popcount64( b.bits & ( ( std::uint64_t( 1 ) << ( i % block_bits ) ) - 1 ) );
+    }
+
+    void check( size_type i ) const
+    {
+#if nsel_CONFIG_NO_EXCEPTIONS
+        nsel_VECTOR_ASSERT( i < m_size );
+#else
+        if ( i >= m_size )
+            throw std::out_of_range( "expected_vector::at()" );
+#endif
+    }
+
+private:
+    std::vector<T>     m_values;
+    std::vector<E>     m_errors;
+    std::vector<block> m_blocks;
+    size_type          m_size = 0;
+};
+
+template< typename T, typename E >
+const typename expected_vector<T, E>::size_type expected_vector<T, E>::block_bits;
+
+} // namespace expected_lite
+
+using expected_lite::expected_vector;
+using expected_lite::expected_vector_reference;
+
+} // namespace nonstd
+
+#undef nsel_VECTOR_ASSERT
+
+#endif // NONSTD_EXPECTED_LITE_VECTOR_HPP
@@ -0,0 +1,24 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Explicit instantiation definitions of library expected-lite-extern.
+//
+// Users compile with nsel_CONFIG_EXTERN_TEMPLATES=1 and link this library, so
+// that the member functions of expected< T, E > for the types of
+// nsel_CONFIG_EXTERN_TEMPLATE_TYPES are compiled once, here, and not in each
+// translation unit. Library and users must use the same configuration of
+// expected-lite and the same C++ standard.
+
+#ifndef  nsel_CONFIG_EXTERN_TEMPLATES
+# define nsel_CONFIG_EXTERN_TEMPLATES  1
+#endif
+
+#define nsel_EXTERN_TEMPLATES_DEFINITION  1
+
+#include "nonstd/expected.hpp"
+
+// end of file
@@ -0,0 +1,84 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// C++20 module interface unit of module nonstd.expected.
+//
+// The module exports expected-lite as configured when the module is built,
+// e.g. via nsel_CONFIG_NO_EXCEPTIONS, nsel_P0323R and nsel_P2505R, see CMake
+// options EXPECTED_LITE_OPT_MODULE_*. A module doesn't export macros: include
+// expected.hpp to use nsel_TRY() and nsel_TRY_VOID().
+
+module;
+
+#include "nonstd/expected.hpp"
+#include "nonstd/expected_collect.hpp"
+
+export module nonstd.expected;
+
+export namespace nonstd {
+
+using nonstd::in_place;
+using nonstd::in_place_t;
+using nonstd::in_place_type;
+using nonstd::in_place_type_t;
+using nonstd::in_place_index;
+using nonstd::in_place_index_t;
+
+using nonstd::expected;
+using nonstd::unexpected_type;
+using nonstd::unexpected;
+using nonstd::unexpect_t;
+using nonstd::unexpect;
+using nonstd::bad_expected_access;
+using nonstd::make_unexpected;
+
+#if !nsel_USES_STD_EXPECTED
+
+using nonstd::in_place_unexpected_t;
+using nonstd::in_place_unexpected;
+using nonstd::error_traits;
+using nonstd::niche_traits;
+using nonstd::niche_byte;
+using nonstd::niche_null_pointer;
+using nonstd::swap;
+
+#if nsel_CONFIG_RELATIONAL_OPERATORS
+using nonstd::operator==;
+using nonstd::operator!=;
+
+#if nsel_P0323R <= 2
+using nonstd::operator<;
+using nonstd::operator>;
+using nonstd::operator<=;
+using nonstd::operator>=;
+#endif
+#endif // nsel_CONFIG_RELATIONAL_OPERATORS
+
+#if nsel_P0323R <= 3
+using nonstd::is_unexpected;
+using nonstd::make_expected;
+using nonstd::make_expected_from_exception;
+#if nsel_CONFIG_CURRENT_EXCEPTION
+using nonstd::make_unexpected_from_current_exception;
+using nonstd::make_expected_from_current_exception;
+using nonstd::make_expected_from_call;
+#endif
+#endif
+
+using nonstd::contract_violation_handler;
+using nonstd::set_contract_violation_handler;
+
+#endif // nsel_USES_STD_EXPECTED
+
+using nonstd::collect;
+using nonstd::sequence;
+
+#if nsel_CONFIG_PARALLEL_COLLECT
+using nonstd::transform_collect;
+#endif
+
+} // namespace nonstd
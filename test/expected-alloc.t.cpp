@@ -0,0 +1,278 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// expected-lite-alloc.t: verify that expected<T,E> and expected<void,E> do not
+// allocate on their hot paths for T and E that do not allocate themselves.
+//
+// This program replaces the global operator new and operator delete by versions
+// that count their calls, hence it is a program of its own. Each check counts
+// the calls during one operation, the checks themselves may allocate.
+//
+// The paths via std::exception_ptr are not checked, but reported: the C++
+// runtime allocates the exception object itself, outside operator new.
+
+#include "expected-main.t.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+// count the calls of operator new and operator delete; the array and nothrow
+// versions of the library call these. The types used are not over-aligned:
+
+namespace {
+
+long allocation_calls = 0;
+
+} // anonymous namespace
+
+void * operator new( std::size_t size )
+{
+    ++allocation_calls;
+
+    if ( void * p = std::malloc( size ? size : 1 ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete( void * p ) noexcept
+{
+    if ( p )
+        ++allocation_calls;
+
+    std::free( p );
+}
+
+#if defined( __cpp_sized_deallocation )
+void operator delete( void * p, std::size_t ) noexcept
+{
+    ::operator delete( p );
+}
+#endif
+
+lest::tests & specification()
+{
+    static lest::tests tests;
+    return tests;
+}
+
+using namespace nonstd;
+
+namespace {
+
+// the number of calls of operator new and operator delete by f:
+
+template< typename F >
+long allocations( F f )
+{
+    const long before = allocation_calls;
+    f();
+    return allocation_calls - before;
+}
+
+// a value type with non-trivial special members that does not allocate:
+
+struct NonTrivial
+{
+    int v;
+
+    NonTrivial( int v_ ) : v( v_ ) {}
+    NonTrivial( NonTrivial const & other ) : v( other.v ) {}
+    NonTrivial( NonTrivial && other ) noexcept : v( other.v ) {}
+    ~NonTrivial() {}
+
+    NonTrivial & operator=( NonTrivial const & other ) { v = other.v; return *this; }
+    NonTrivial & operator=( NonTrivial && other ) noexcept { v = other.v; return *this; }
+};
+
+inline bool operator==( NonTrivial const & a, NonTrivial const & b ) { return a.v == b.v; }
+
+// the hot paths of expected<T,E> for value t and error g:
+
+template< typename T, typename E >
+void expect_no_allocations( lest::env & lest_env, T const & t, E const & g )
+{
+    using EX = expected<T, E>;
+
+    EX v( t );
+    EX e( make_unexpected( g ) );
+
+    // construction:
+
+    EXPECT( allocations( [&]{ EX x( t ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( in_place, t ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( unexpect, g ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( make_unexpected( g ) ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( v ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX a( v ); EX x( std::move( a ) ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX a( e ); EX x( std::move( a ) ); } ) == 0 );
+
+    // assignment, in each combination of states:
+
+    EXPECT( allocations( [&]{ EX x( v ); x = v; } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( v ); x = e; } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); x = v; } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); x = e; } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); EX a( v ); x = std::move( a ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( v ); EX a( e ); x = std::move( a ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); x = t; } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( v ); x = make_unexpected( g ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); x.emplace( t ); } ) == 0 );
+
+    // swap, in each combination of states:
+
+    EXPECT( allocations( [&]{ EX x( v ); EX y( v ); x.swap( y ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( v ); EX y( e ); x.swap( y ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); EX y( v ); x.swap( y ); } ) == 0 );
+    EXPECT( allocations( [&]{ EX x( e ); EX y( e ); swap( x, y ); } ) == 0 );
+
+    // observers and comparison:
+
+    EXPECT( allocations( [&]{ (void) v.value(); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) v.value_or( t ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) e.value_or( t ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) ( v == e ); } ) == 0 );
+#if nsel_P2505R >= 4
+    EXPECT( allocations( [&]{ (void) v.error_or( g ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) e.error_or( g ); } ) == 0 );
+#endif
+
+    // propagation and chained monadic operations, on either path:
+
+    EXPECT( allocations( [&]{ (void) [&]() -> EX { nsel_TRY( T x, v ); return x; }(); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) [&]() -> EX { nsel_TRY( T x, e ); return x; }(); } ) == 0 );
+
+#if nsel_P2505R >= 3
+    const auto then_     = []( T const & x ) { return EX( x ); };
+    const auto else_     = []( E const & x ) { return EX( unexpect, x ); };
+    const auto identity  = []( T const & x ) { return x; };
+    const auto identity_ = []( E const & x ) { return x; };
+
+    EXPECT( allocations( [&]{ (void) v.and_then( then_ ).transform( identity ).or_else( else_ ).transform_error( identity_ ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) e.and_then( then_ ).transform( identity ).or_else( else_ ).transform_error( identity_ ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) EX( v ).and_then( then_ ).transform( identity ).or_else( else_ ).transform_error( identity_ ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) EX( e ).and_then( then_ ).transform( identity ).or_else( else_ ).transform_error( identity_ ); } ) == 0 );
+#endif
+}
+
+// the hot paths of expected<void,E> for error g:
+
+template< typename E >
+void expect_no_allocations_void( lest::env & lest_env, E const & g )
+{
+    using EV = expected<void, E>;
+
+    EV v;
+    EV e( make_unexpected( g ) );
+
+    EXPECT( allocations( [&]{ EV x; } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( unexpect, g ); } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( e ); } ) == 0 );
+    EXPECT( allocations( [&]{ EV a( e ); EV x( std::move( a ) ); } ) == 0 );
+
+    EXPECT( allocations( [&]{ EV x( v ); x = e; } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( e ); x = v; } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( e ); x = e; } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( v ); x = make_unexpected( g ); } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( e ); x.emplace(); } ) == 0 );
+
+    EXPECT( allocations( [&]{ EV x( v ); EV y( e ); x.swap( y ); } ) == 0 );
+    EXPECT( allocations( [&]{ EV x( e ); EV y( e ); swap( x, y ); } ) == 0 );
+
+    EXPECT( allocations( [&]{ v.value(); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) ( v == e ); } ) == 0 );
+#if nsel_P2505R >= 4
+    EXPECT( allocations( [&]{ (void) e.error_or( g ); } ) == 0 );
+#endif
+
+    EXPECT( allocations( [&]{ (void) [&]() -> EV { nsel_TRY_VOID( e ); return {}; }(); } ) == 0 );
+
+#if nsel_P2505R >= 3
+    const auto then_     = []() { return EV(); };
+    const auto else_     = []( E const & x ) { return EV( unexpect, x ); };
+    const auto nothing   = []() {};
+    const auto identity_ = []( E const & x ) { return x; };
+
+    EXPECT( allocations( [&]{ (void) v.and_then( then_ ).transform( nothing ).or_else( else_ ).transform_error( identity_ ); } ) == 0 );
+    EXPECT( allocations( [&]{ (void) e.and_then( then_ ).transform( nothing ).or_else( else_ ).transform_error( identity_ ); } ) == 0 );
+#endif
+}
+
+} // anonymous namespace
+
+CASE( "expected: Does not allocate on its hot paths, trivial value and error" "[alloc]" )
+{
+    expect_no_allocations( lest_env, 42, std::errc::invalid_argument );
+}
+
+CASE( "expected: Does not allocate on its hot paths, non-trivial value and error" "[alloc]" )
+{
+    expect_no_allocations( lest_env, NonTrivial( 42 ), std::make_error_code( std::errc::invalid_argument ) );
+}
+
+CASE( "expected<void>: Does not allocate on its hot paths" "[alloc]" )
+{
+    expect_no_allocations_void( lest_env, std::errc::invalid_argument );
+    expect_no_allocations_void( lest_env, std::make_error_code( std::errc::invalid_argument ) );
+}
+
+CASE( "expected: Reports the allocations on the paths via std::exception_ptr" "[alloc][exception]" )
+{
+    using EP = expected<int, std::exception_ptr>;
+
+    // the message of std::runtime_error may allocate, hence create it beforehand:
+
+    const std::exception_ptr error = std::make_exception_ptr( std::runtime_error( "error" ) );
+
+    const auto report = []( char const * path, long count )
+    {
+        std::cout << "  " << path << ": " << count << "\n";
+    };
+
+    std::cout << "Calls of operator new and delete, besides the exception object of the C++ runtime:\n";
+
+    report( "value() throws bad_expected_access", allocations( []
+    {
+        try { (void) expected<int, int>( unexpect, 7 ).value(); } catch ( std::exception const & ) {}
+    } ) );
+
+    report( "make_unexpected( std::current_exception() )", allocations( [&]
+    {
+        try { std::rethrow_exception( error ); } catch ( ... ) { EP x( make_unexpected( std::current_exception() ) ); }
+    } ) );
+
+#if nsel_P0323R <= 3
+    report( "make_unexpected_from_current_exception()", allocations( [&]
+    {
+        try { std::rethrow_exception( error ); } catch ( ... ) { EP x( make_unexpected_from_current_exception() ); }
+    } ) );
+#endif
+
+    report( "copy of expected<int, std::exception_ptr> with error", allocations( [&]
+    {
+        EP x( make_unexpected( error ) ); EP y( x ); y = x;
+    } ) );
+
+    report( "value() rethrows std::exception_ptr", allocations( [&]
+    {
+        try { (void) EP( make_unexpected( error ) ).value(); } catch ( std::exception const & ) {}
+    } ) );
+
+    EXPECT( allocations( []{ EP x( 42 ); EP y( x ); y = x; } ) == 0 );
+}
+
+int main( int argc, char * argv[] )
+{
+    return lest::run( specification(), argc, argv );
+}
+
+// end of file
@@ -0,0 +1,179 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "expected-main.t.hpp"
+#include "expected-results.t.hpp"
+#include "nonstd/expected_batch.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace nonstd;
+
+namespace {
+
+using Batch = sparse_expected_batch<int, std::string>;
+
+using results::make_results;
+using results::Throws;
+
+} // anonymous namespace
+
+CASE( "sparse_expected_batch: Allows to append values and errors in order" "[batch]" )
+{
+    Batch b;
+
+    b.push_back( 1 );
+    b.push_back( make_unexpected( std::string( "two" ) ) );
+    b.push_back( expected<int, std::string>( 3 ) );
+    b.push_back( expected<int, std::string>( unexpect, "four" ) );
+    b.emplace_back( 5 );
+    b.emplace_error_back( std::size_t( 3 ), 'x' );
+
+    EXPECT( b.size() == 6u );
+    EXPECT( b.count_values() == 3u );
+    EXPECT( b.count_errors() == 3u );
+
+    EXPECT( *b[0] == 1 );
+    EXPECT(  b[1].error() == "two" );
+    EXPECT( *b[2] == 3 );
+    EXPECT(  b[3].error() == "four" );
+    EXPECT( *b[4] == 5 );
+    EXPECT(  b[5].error() == "xxx" );
+}
+
+CASE( "sparse_expected_batch: Keeps a value per element, value-initialized for an error" "[batch]" )
+{
+    Batch b = make_results<Batch>( 6, 4 );
+
+    EXPECT( b.values() == ( std::vector<int>{ 0, 1, 2, 3, 0, 5 } ) );
+}
+
+CASE( "sparse_expected_batch: Allows to access an element as a view like expected<T const&,E const&>" "[batch]" )
+{
+    const Batch b = make_results<Batch>( 5, 3 );
+
+    EXPECT( !b[0] );
+    EXPECT(  b[1] );
+    EXPECT(  b[1].value() == 1 );
+    EXPECT(  b[3].error() == "3" );
+    EXPECT(  b[3].value_or( 7 ) == 7 );
+    EXPECT(  b.at( 4 ).value() == 4 );
+    EXPECT(  b.has_value( 4 ) );
+    EXPECT( !b.has_value( 3 ) );
+
+    EXPECT_THROWS_AS( b[0].value(), bad_expected_access<std::string> );
+    EXPECT_THROWS_AS( b.at( 5 ), std::out_of_range );
+
+    expected<int, std::string> x = b[3];
+
+    EXPECT( x.error() == "3" );
+}
+
+CASE( "sparse_expected_batch: Allows to modify a value or an error in place" "[batch]" )
+{
+    Batch b = make_results<Batch>( 4, 2 );
+
+    *b[1] = 10;
+    b[2].error() = "changed";
+
+    EXPECT( *b[1] == 10 );
+    EXPECT( b[2].error() == "changed" );
+}
+
+CASE( "sparse_expected_batch: Reports whether any element failed and iterates over the failures" "[batch]" )
+{
+    Batch b;
+    for ( int i = 0; i < 100; ++i )
+        b.push_back( i );
+
+    EXPECT( !b.has_errors() );
+    EXPECT( b.first_error() == b.size() );
+
+    Batch c = make_results<Batch>( 1000, 250 );
+
+    std::vector<std::size_t> indices;
+    std::vector<std::string> errors;
+
+    for ( auto const & f : c.errors() )
+    {
+        indices.push_back( f.index );
+        errors.push_back( f.error );
+    }
+
+    EXPECT( c.has_errors() );
+    EXPECT( indices == ( std::vector<std::size_t>{ 0, 250, 500, 750 } ) );
+    EXPECT( errors  == ( std::vector<std::string>{ "0", "250", "500", "750" } ) );
+
+    EXPECT( c.first_error(   1 ) == 250u );
+    EXPECT( c.first_error( 250 ) == 250u );
+    EXPECT( c.first_error( 751 ) == c.size() );
+}
+
+CASE( "sparse_expected_batch: Allows to change the errors of the failures, not their indices" "[batch]" )
+{
+    static_assert( std::is_const< decltype( Batch::failure_reference::index ) >::value, "index of a failure must be const" );
+
+    Batch b = make_results<Batch>( 10, 5 );
+
+    for ( auto f : b.errors() )
+    {
+        f.error += "!";
+    }
+
+    EXPECT( b[0].error() == "0!" );
+    EXPECT( b[5].error() == "5!" );
+    EXPECT( b.first_error( 1 ) == 5u );
+}
+
+CASE( "sparse_expected_batch: Allows to iterate over all elements" "[batch]" )
+{
+    Batch b = make_results<Batch>( 10, 3 );
+
+    std::vector<int> values;
+    std::size_t failed = 0;
+
+    for ( Batch::const_reference x : b )
+    {
+        if ( x ) values.push_back( *x );
+        else     ++failed;
+    }
+
+    EXPECT( values == ( std::vector<int>{ 1, 2, 4, 5, 7, 8 } ) );
+    EXPECT( failed == 4u );
+}
+
+CASE( "sparse_expected_batch: Leaves the batch unchanged if the construction of an error throws" "[batch]" )
+{
+    sparse_expected_batch<int, Throws> b;
+
+    b.push_back( 1 );
+
+    EXPECT_THROWS_AS( b.emplace_error_back( -1 ), std::runtime_error );
+    EXPECT( b.size() == 1u );
+    EXPECT( !b.has_errors() );
+
+    b.emplace_error_back( 2 );
+
+    EXPECT( b.size() == 2u );
+    EXPECT( b[1].error().v == 2 );
+}
+
+CASE( "sparse_expected_batch: Allows to clear the batch" "[batch]" )
+{
+    Batch b = make_results<Batch>( 10, 3 );
+
+    b.clear();
+
+    EXPECT( b.empty() );
+    EXPECT( !b.has_errors() );
+    EXPECT( b.begin() == b.end() );
+}
+
+// end of file
@@ -0,0 +1,198 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The bulk algorithms of nonstd/expected_bulk.hpp against a scalar reference,
+// for each instruction set this machine supports, for several element sizes
+// and for lengths that leave a tail after the chunks.
+
+#include "expected-main.t.hpp"
+#include "nonstd/expected_bulk.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace nonstd;
+
+namespace {
+
+enum class Status : unsigned char { ok, timeout, overflow };
+enum class Errc : int { ok, invalid, range };
+
+// a 5-byte error, for an element size that is no power of two:
+
+struct Code
+{
+    char text[5];
+};
+
+bool operator==( Code const & a, Code const & b )
+{
+    return std::equal( a.text, a.text + 5, b.text );
+}
+
+bulk_isa const isas[] = { bulk_isa::scalar, bulk_isa::sse2, bulk_isa::avx2, bulk_isa::avx512bw };
+
+// lengths around the chunks of 16, 32 and 64 bytes for the smallest elements,
+// and one beyond the 255 chunks of a run of SSE2 for elements of 2 bytes:
+
+std::size_t const lengths[] = { 0, 1, 7, 8, 9, 31, 32, 33, 63, 64, 65, 100, 2100 };
+
+// lengths beyond a run of 255 chunks for each instruction set, for [.bulk]:
+
+std::size_t const long_lengths[] = { 5000, 20000 };
+
+// n elements with an error at pseudo-random places, roughly one in period:
+
+template< typename T, typename E >
+std::vector< expected<T, E> > make_data( std::size_t n, unsigned period, E error )
+{
+    std::vector< expected<T, E> > data;
+    unsigned state = 12345;
+
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        state = state * 1103515245u + 12345u;
+
+        if ( ( state >> 16 ) % period == 0 ) data.push_back( make_unexpected( error ) );
+        else                                 data.push_back( static_cast<T>( i % 100 ) );
+    }
+    return data;
+}
+
+template< typename T, typename E >
+void check_bulk( lest::env & lest_env, std::size_t n, unsigned period, E error, bulk_isa isa )
+{
+    using X = expected<T, E>;
+
+    const std::vector<X> data = make_data<T, E>( n, period, error );
+
+    X const * first = data.data();
+
+    // the reference:
+
+    std::size_t count = 0, found = n;
+    std::vector<T> dense;
+    std::vector< expected<long, E> > doubled;
+    std::vector<std::size_t> values, errors;
+
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        count += data[i].has_value();
+        found  = found == n && !data[i].has_value() ? i : found;
+
+        dense.push_back( data[i].value_or( T( 42 ) ) );
+        doubled.push_back( data[i].has_value() ? expected<long, E>( 2 * static_cast<long>( *data[i] ) ) : expected<long, E>( unexpect, data[i].error() ) );
+        ( data[i].has_value() ? values : errors ).push_back( i );
+    }
+
+    EXPECT( count_values( first, n, isa ) == count );
+    EXPECT( find_error( first, n, isa ) == found );
+
+    std::vector<T> dense_bulk( n );
+    values_or( first, n, dense_bulk.data(), T( 42 ), isa );
+    EXPECT( dense_bulk == dense );
+
+    std::vector< expected<long, E> > doubled_bulk( n, expected<long, E>( 0 ) );
+    transform_values( first, n, doubled_bulk.data(), []( T x ) { return 2 * static_cast<long>( x ); } );
+    EXPECT( doubled_bulk == doubled );
+
+    std::vector<std::size_t> values_bulk, errors_bulk;
+    partition_indices( first, n, values_bulk, errors_bulk, isa );
+    EXPECT( values_bulk == values );
+    EXPECT( errors_bulk == errors );
+}
+
+template< typename T, typename E, std::size_t N >
+void check_bulk_all( lest::env & lest_env, E error, std::size_t const (&ns)[N] )
+{
+    for ( bulk_isa isa : isas )
+    {
+        for ( std::size_t n : ns )
+        {
+            check_bulk<T, E>( lest_env, n,    1, error, isa );     // all errors
+            check_bulk<T, E>( lest_env, n,    3, error, isa );
+            check_bulk<T, E>( lest_env, n,  200, error, isa );
+            check_bulk<T, E>( lest_env, n, 1u << 15, error, isa ); // all values, almost
+        }
+    }
+}
+
+template< typename T, typename E >
+void check_bulk_all( lest::env & lest_env, E error )
+{
+    check_bulk_all<T>( lest_env, error, lengths );
+}
+
+} // anonymous namespace
+
+CASE( "bulk: Reports an instruction set" "[bulk]" )
+{
+    EXPECT( detected_bulk_isa() >= bulk_isa::scalar );
+    EXPECT( detected_bulk_isa() <= bulk_isa::avx512bw );
+}
+
+CASE( "bulk: Appends the indices of the values and of the errors" "[bulk]" )
+{
+    const std::vector< expected<int, Status> > data = make_data<int, Status>( 100, 3, Status::timeout );
+
+    std::vector<std::size_t> values( 1, 7 ), errors( 2, 7 );
+
+    partition_indices( data.data(), data.size(), values, errors );
+
+    EXPECT( values.size() == 1 + count_values( data.data(), data.size() ) );
+    EXPECT( values.size() + errors.size() == 103u );
+    EXPECT( values[0] == 7u );
+    EXPECT( errors[1] == 7u );
+    EXPECT( errors[2] == find_error( data.data(), data.size() ) );
+}
+
+CASE( "bulk: Agrees with a scalar loop for an element of 2 bytes" "[bulk]" )
+{
+    check_bulk_all<signed char>( lest_env, Status::timeout );
+}
+
+CASE( "bulk: Agrees with a scalar loop for an element of 4 bytes" "[bulk]" )
+{
+    check_bulk_all<short>( lest_env, Status::overflow );
+}
+
+CASE( "bulk: Agrees with a scalar loop for an element of 8 bytes" "[bulk]" )
+{
+    check_bulk_all<int>  ( lest_env, Errc::invalid );
+    check_bulk_all<float>( lest_env, Status::timeout );
+}
+
+CASE( "bulk: Agrees with a scalar loop for an element of 16 bytes" "[bulk]" )
+{
+    check_bulk_all<double>( lest_env, Errc::range );
+    check_bulk_all<long long>( lest_env, Status::timeout );
+}
+
+CASE( "bulk: Agrees with a scalar loop for an element of 32 bytes" "[bulk]" )
+{
+    check_bulk_all<long double>( lest_env, Errc::range );
+}
+
+CASE( "bulk: Agrees with a scalar loop for an element size that is no power of two" "[bulk]" )
+{
+    check_bulk_all<char>( lest_env, Code{ { 'e', 'r', 'r', 'o', 'r' } } );
+}
+
+CASE( "bulk: Agrees with a scalar loop for long arrays" "[.bulk]" )
+{
+    check_bulk_all<signed char>( lest_env, Status::timeout, long_lengths );
+    check_bulk_all<short>      ( lest_env, Status::overflow, long_lengths );
+    check_bulk_all<int>        ( lest_env, Errc::invalid, long_lengths );
+    check_bulk_all<float>      ( lest_env, Status::timeout, long_lengths );
+    check_bulk_all<double>     ( lest_env, Errc::range, long_lengths );
+    check_bulk_all<long long>  ( lest_env, Status::timeout, long_lengths );
+    check_bulk_all<long double>( lest_env, Errc::range, long_lengths );
+    check_bulk_all<char>       ( lest_env, Code{ { 'e', 'r', 'r', 'o', 'r' } }, long_lengths );
+}
+
+// end of file
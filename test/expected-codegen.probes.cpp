@@ -0,0 +1,156 @@
+// Probe functions for expected-lite-codegen.t: each function is compiled with
+// -O2 -DNDEBUG, disassembled with objdump and checked against the directives
+// that precede it (x86-64, AT&T syntax):
+//
+//   CHECK-LABEL: name   the checks that follow apply to function name, not to its cold part name.cold
+//   CHECK: text         an instruction or relocation of the function contains text
+//   CHECK-NOT: text     no instruction or relocation of the function contains text
+//   CHECK-STACK: n      the function uses at most n bytes of stack: pushes, sub from %rsp and red zone
+//   CHECK-NO-EH         the function has no exception table (.gcc_except_table)
+//
+// Relocations are included, hence 'CHECK-NOT: R_X86_64_PLT32' also rejects a tail call.
+
+#include "nonstd/expected.hpp"
+
+#include <system_error>
+
+using namespace nonstd;
+
+using expected_int = expected<int, std::errc>;
+
+extern expected_int produce( int ) noexcept;
+
+// Suppress:
+// - C linkage of a function returning expected_int, a class: C linkage only keeps the names unmangled for the checks
+#if defined(__clang__)
+# pragma clang diagnostic push
+# pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#endif
+
+extern "C" {
+
+// observers:
+
+// CHECK-LABEL: probe_has_value
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 0
+// CHECK-NO-EH
+
+bool probe_has_value( expected_int const & e ) noexcept
+{
+    return e.has_value();
+}
+
+// CHECK-LABEL: probe_deref
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 0
+// CHECK-NO-EH
+
+int probe_deref( expected_int const & e ) noexcept
+{
+    return *e;
+}
+
+// CHECK-LABEL: probe_value_or
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 0
+// CHECK-NO-EH
+
+int probe_value_or( expected_int const & e ) noexcept
+{
+    return e.value_or( 0 );
+}
+
+// value() reports an error out of line, in the cold part:
+
+// CHECK-LABEL: probe_value
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 0
+
+int probe_value( expected_int const & e )
+{
+    return e.value();
+}
+
+// return by value in registers, not via a hidden pointer in %rdi:
+
+// CHECK-LABEL: probe_return
+// CHECK-NOT: call
+// CHECK-NOT: (%rdi)
+// CHECK-STACK: 8
+// CHECK-NO-EH
+
+expected_int probe_return( int x ) noexcept
+{
+    if ( x < 0 )
+        return make_unexpected( std::errc::invalid_argument );
+
+    return x;
+}
+
+// propagation:
+
+// CHECK-LABEL: probe_try
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 8
+// CHECK-NO-EH
+
+expected_int probe_try( expected_int const & e ) noexcept
+{
+    nsel_TRY( int v, e );
+    return v + 1;
+}
+
+// a noexcept caller of a noexcept function that returns expected:
+
+// CHECK-LABEL: probe_call
+// CHECK: call
+// CHECK-STACK: 24
+// CHECK-NO-EH
+
+int probe_call( int x ) noexcept
+{
+    const expected_int r = produce( x );
+    return r ? *r + 1 : -1;
+}
+
+// monadic operations, on the success path:
+
+#if nsel_P2505R >= 3
+
+// CHECK-LABEL: probe_and_then
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 8
+// CHECK-NO-EH
+
+expected_int probe_and_then( expected_int const & e ) noexcept
+{
+    return e.and_then( []( int v ) noexcept { return expected_int( v + 1 ); } );
+}
+
+// CHECK-LABEL: probe_transform
+// CHECK-NOT: call
+// CHECK-NOT: R_X86_64_PLT32
+// CHECK-STACK: 8
+// CHECK-NO-EH
+
+expected_int probe_transform( expected_int const & e ) noexcept
+{
+    return e.transform( []( int v ) noexcept { return v + 1; } );
+}
+
+#endif // nsel_P2505R >= 3
+
+} // extern "C"
+
+#if defined(__clang__)
+# pragma clang diagnostic pop
+#endif
+
+// end of file
@@ -0,0 +1,322 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// expected-lite-codegen.t: check the generated code of the probe functions in
+// expected-codegen.probes.cpp against the CHECK directives in that file.
+//
+// For each C++ standard, compile the probes with -O2 -DNDEBUG, disassemble the
+// object file with objdump and read its sections with readelf (x86-64, ELF).
+//
+// The compiler, objdump, readelf, include directory, source and standards are configured by CMake.
+//
+// Usage: expected-lite-codegen.t [--verbose [--verbose]], twice also shows the code of passed probes
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef codegen_CXX_COMPILER
+# error codegen_CXX_COMPILER must name the compiler to check
+#endif
+
+#ifndef codegen_STANDARDS
+# define codegen_STANDARDS  "11 17 20"
+#endif
+
+namespace {
+
+char const * const object_file = "expected-codegen.probes.o";
+
+struct directive
+{
+    std::string kind;       // CHECK, CHECK-NOT, CHECK-STACK, CHECK-NO-EH
+    std::string argument;
+    int line;
+};
+
+struct probe
+{
+    std::string name;
+    std::vector<directive> directives;
+};
+
+// run a command and capture its standard output:
+
+bool run( std::string const & cmd, std::string & output )
+{
+    std::FILE * pipe = popen( cmd.c_str(), "r" );
+    if ( ! pipe )
+        return false;
+
+    char buffer[4096];
+    output.clear();
+
+    for ( std::size_t n; ( n = std::fread( buffer, 1, sizeof buffer, pipe ) ) > 0; )
+        output.append( buffer, n );
+
+    return pclose( pipe ) == 0;
+}
+
+std::string trim( std::string const & text )
+{
+    const std::size_t first = text.find_first_not_of( " \t" );
+    const std::size_t last  = text.find_last_not_of( " \t\r" );
+
+    return first == std::string::npos ? std::string() : text.substr( first, last - first + 1 );
+}
+
+// directives in comments: '// CHECK-LABEL: name', '// CHECK-NOT: text', etc.:
+
+bool read_probes( std::string const & file, std::vector<probe> & probes )
+{
+    std::ifstream in( file.c_str() );
+    if ( ! in )
+    {
+        std::fprintf( stderr, "error: cannot read '%s'\n", file.c_str() );
+        return false;
+    }
+
+    int number = 0;
+
+    for ( std::string line; std::getline( in, line ); )
+    {
+        ++number;
+        line = trim( line );
+
+        if ( line.compare( 0, 8, "// CHECK" ) != 0 )
+            continue;
+
+        const std::size_t colon = line.find( ':' );
+        const std::string kind = trim( line.substr( 3, colon == std::string::npos ? std::string::npos : colon - 3 ) );
+        const std::string argument = colon == std::string::npos ? std::string() : trim( line.substr( colon + 1 ) );
+
+        if ( kind == "CHECK-LABEL" )
+        {
+            probes.push_back( { argument, {} } );
+        }
+        else if ( probes.empty() )
+        {
+            std::fprintf( stderr, "%s:%d: error: %s before CHECK-LABEL\n", file.c_str(), number, kind.c_str() );
+            return false;
+        }
+        else if ( kind == "CHECK" || kind == "CHECK-NOT" || kind == "CHECK-STACK" || kind == "CHECK-NO-EH" )
+        {
+            probes.back().directives.push_back( { kind, argument, number } );
+        }
+        else
+        {
+            std::fprintf( stderr, "%s:%d: error: unknown directive '%s'\n", file.c_str(), number, kind.c_str() );
+            return false;
+        }
+    }
+    return true;
+}
+
+// instructions and relocations per function, from objdump --disassemble --reloc:
+// 0000000000000000 <name>:
+//    0:   cmpb   $0x0,0x4(%rdi)
+//             6: R_X86_64_PC32    .text.unlikely.name-0x4
+
+std::map<std::string, std::vector<std::string>> functions_of( std::string const & disassembly )
+{
+    std::map<std::string, std::vector<std::string>> functions;
+    std::vector<std::string> * current = nullptr;
+    std::istringstream lines( disassembly );
+
+    for ( std::string line; std::getline( lines, line ); )
+    {
+        const std::size_t open = line.find( " <" );
+
+        if ( open != std::string::npos && line.size() > 2 && line.compare( line.size() - 2, 2, ">:" ) == 0 )
+            current = &functions[ line.substr( open + 2, line.size() - open - 4 ) ];
+        else if ( line.compare( 0, 12, "Disassembly " ) == 0 )
+            current = nullptr;
+        else if ( current && trim( line ).size() )
+            current->push_back( trim( line ) );
+    }
+    return functions;
+}
+
+// functions with an exception table, from the names of sections .gcc_except_table.name:
+
+std::set<std::string> exception_tables_of( std::string const & sections )
+{
+    std::set<std::string> names;
+    std::istringstream lines( sections );
+    const std::string prefix = ".gcc_except_table.";
+
+    for ( std::string line; std::getline( lines, line ); )
+    {
+        const std::size_t pos = line.find( prefix );
+        if ( pos == std::string::npos )
+            continue;
+
+        std::istringstream fields( line.substr( pos + prefix.size() ) );
+        std::string name;
+        fields >> name;
+        names.insert( name );
+    }
+    return names;
+}
+
+// stack used: pushes, 'sub $n,%rsp' and the deepest red zone access -n(%rsp):
+
+long stack_of( std::vector<std::string> const & instructions )
+{
+    long frame = 0, red_zone = 0;
+
+    for ( auto const & instruction : instructions )
+    {
+        const std::size_t tab = instruction.find( '\t' );
+        if ( tab == std::string::npos )
+            continue;
+
+        const std::string text = trim( instruction.substr( tab + 1 ) );
+
+        if ( text.compare( 0, 4, "push" ) == 0 )
+            frame += 8;
+
+        if ( text.compare( 0, 3, "sub" ) == 0 && text.find( ",%rsp" ) != std::string::npos && text.find( '$' ) != std::string::npos )
+            frame += std::strtol( text.c_str() + text.find( '$' ) + 1, nullptr, 0 );
+
+        for ( std::size_t pos = 0; ( pos = text.find( "(%rsp)", pos ) ) != std::string::npos; ++pos )
+        {
+            const std::size_t start = text.find_last_of( " ,", pos );
+            const long offset = std::strtol( text.substr( start + 1, pos - start - 1 ).c_str(), nullptr, 0 );
+
+            if ( offset < 0 && -offset > red_zone )
+                red_zone = -offset;
+        }
+    }
+    return frame + red_zone;
+}
+
+int check( std::string const & config, probe const & p, std::map<std::string, std::vector<std::string>> const & functions, std::set<std::string> const & exception_tables, int verbose )
+{
+    const auto function = functions.find( p.name );
+
+    if ( function == functions.end() )
+    {
+        std::printf( "%s: %s: failed: function not found\n", config.c_str(), p.name.c_str() );
+        return 1;
+    }
+
+    std::vector<std::string> const & instructions = function->second;
+    int failures = 0;
+
+    for ( auto const & d : p.directives )
+    {
+        std::string found;
+
+        for ( auto const & instruction : instructions )
+        {
+            if ( instruction.find( d.argument ) != std::string::npos )
+            {
+                found = instruction;
+                break;
+            }
+        }
+
+        std::string failure;
+
+        if      ( d.kind == "CHECK"       && found.empty() ) failure = "not found";
+        else if ( d.kind == "CHECK-NOT"   && found.size()  ) failure = "found '" + found + "'";
+        else if ( d.kind == "CHECK-NO-EH" && exception_tables.count( p.name ) ) failure = "has an exception table";
+        else if ( d.kind == "CHECK-STACK" && stack_of( instructions ) > std::atol( d.argument.c_str() ) )
+            failure = "uses " + std::to_string( stack_of( instructions ) ) + " bytes of stack";
+
+        if ( failure.size() )
+        {
+            const std::string text = d.argument.empty() ? d.kind : d.kind + ": " + d.argument;
+
+            std::printf( "%s: %s: failed: line %d: %s: %s\n", config.c_str(), p.name.c_str(), d.line, text.c_str(), failure.c_str() );
+            ++failures;
+        }
+    }
+
+    if ( failures || verbose )
+    {
+        std::printf( "%s: %s: %s\n", config.c_str(), p.name.c_str(), failures ? "code:" : "passed" );
+
+        if ( failures || verbose > 1 )
+            for ( auto const & instruction : instructions )
+                std::printf( "    %s\n", instruction.c_str() );
+    }
+    return failures;
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    int verbose = 0;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--verbose" ) ) ++verbose;
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--verbose [--verbose]]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<probe> probes;
+
+    if ( ! read_probes( codegen_SOURCE, probes ) )
+        return EXIT_FAILURE;
+
+    int failures = 0, checks = 0;
+    std::istringstream standards( codegen_STANDARDS );
+
+    for ( int std; standards >> std; )
+    {
+        const std::string config = "c++" + std::to_string( std );
+        const std::string compile = std::string( "\"" codegen_CXX_COMPILER "\" -std=c++" ) + std::to_string( std )
+            + " -O2 -DNDEBUG -c -ffunction-sections -Dnsel_CONFIG_SELECT_EXPECTED=nsel_EXPECTED_NONSTD"
+            + " -I\"" codegen_INCLUDE_DIR "\" \"" codegen_SOURCE "\" -o " + object_file;
+
+        if ( std::system( compile.c_str() ) != 0 )
+        {
+            std::fprintf( stderr, "error: compilation failed: %s\n", compile.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        std::string disassembly, sections;
+
+        if ( ! run( std::string( "\"" codegen_OBJDUMP "\" --disassemble --reloc --no-show-raw-insn " ) + object_file, disassembly )
+            || ! run( std::string( "\"" codegen_READELF "\" -W --section-headers " ) + object_file, sections ) )
+        {
+            std::fprintf( stderr, "error: cannot read '%s' with " codegen_OBJDUMP " and " codegen_READELF "\n", object_file );
+            return EXIT_FAILURE;
+        }
+
+        const auto functions = functions_of( disassembly );
+        const auto exception_tables = exception_tables_of( sections );
+
+        for ( auto const & p : probes )
+        {
+            failures += check( config, p, functions, exception_tables, verbose );
+            checks += static_cast<int>( p.directives.size() );
+        }
+
+        std::remove( object_file );
+    }
+
+    if ( failures )
+        std::printf( "%d out of %d checks failed\n", failures, checks );
+    else
+        std::printf( "All %d checks passed\n", checks );
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
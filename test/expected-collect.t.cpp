@@ -0,0 +1,143 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "expected-main.t.hpp"
+#include "nonstd/expected_collect.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace nonstd;
+
+namespace {
+
+// value that counts its copies and moves:
+
+struct Counted
+{
+    static int copies;
+    static int moves;
+
+    static void reset() { copies = moves = 0; }
+
+    int v;
+
+    Counted( int v_ ) : v( v_ ) {}
+    Counted( Counted const & other ) : v( other.v ) { ++copies; }
+    Counted( Counted && other ) noexcept : v( other.v ) { ++moves; }
+};
+
+int Counted::copies = 0;
+int Counted::moves  = 0;
+
+} // anonymous namespace
+
+CASE( "collect: Allows to collect the values of a range of expected, or its first error" "[collect]" )
+{
+    std::vector< expected<int, int> > good = { 1, 2, 3 };
+    std::vector< expected<int, int> > bad  = { 1, make_unexpected( 7 ), 3, make_unexpected( 9 ) };
+
+    expected< std::vector<int>, int > eg = collect( good.begin(), good.end() );
+    expected< std::vector<int>, int > eb = collect( bad.begin(), bad.end() );
+
+    EXPECT( eg.has_value() );
+    EXPECT( eg == std::vector<int>( { 1, 2, 3 } ) );
+    EXPECT( ! eb.has_value() );
+    EXPECT( eb.error() == 7 );
+    EXPECT( collect( good.begin(), good.begin() ) == std::vector<int>() );
+}
+
+CASE( "collect: Allows to sequence a range of expected, moving from an rvalue range" "[collect]" )
+{
+    std::vector< expected<Counted, Counted> > values;
+    values.push_back( expected<Counted, Counted>( in_place, 1 ) );
+    values.push_back( expected<Counted, Counted>( in_place, 2 ) );
+
+    Counted::reset();
+
+    expected< std::vector<Counted>, Counted > copied = sequence( values );
+
+    EXPECT( copied.has_value() );
+    EXPECT( Counted::copies == 2 );
+
+    const std::vector<Counted> cv = std::move( copied ).value_or( std::vector<Counted>() );
+
+    EXPECT( cv.size() == 2u );
+    EXPECT( cv.at(1).v == 2 );
+
+    Counted::reset();
+
+    expected< std::vector<Counted>, Counted > moved = sequence( std::move( values ) );
+
+    EXPECT( moved.has_value() );
+    EXPECT( Counted::copies == 0 );
+
+    const std::vector<Counted> mv = std::move( moved ).value_or( std::vector<Counted>() );
+
+    EXPECT( mv.size() == 2u );
+    EXPECT( mv.at(0).v == 1 );
+
+    values.emplace_back( unexpect, 5 );
+
+    EXPECT( sequence( std::move( values ) ).error().v == 5 );
+}
+
+CASE( "collect: Allows to collect with an execution policy (C++17, parallel collect)" "[collect]" )
+{
+#if nsel_HAVE_EXECUTION_POLICY
+    std::vector< expected<std::string, int> > good = { std::string("a"), std::string("b") };
+    std::vector< expected<std::string, int> > bad  = { std::string("a"), make_unexpected( 3 ), make_unexpected( 4 ) };
+
+    EXPECT( collect( std::execution::seq, good.begin(), good.end() ).value() == std::vector<std::string>( { "a", "b" } ) );
+    EXPECT( collect( std::execution::unseq, good.begin(), good.end() ).value().size() == 2u );
+    EXPECT( collect( std::execution::seq, bad.begin(), bad.end() ).error() == 3 );
+#else
+    EXPECT( !!"collect() with an execution policy is not available (no C++17, or nsel_CONFIG_PARALLEL_COLLECT is 0)." );
+#endif
+}
+
+CASE( "collect: Allows to transform_collect a range on several threads, yielding the first error (parallel collect)" "[collect]" )
+{
+#if nsel_CONFIG_PARALLEL_COLLECT
+    std::vector<int> input( 1000 );
+    for ( std::size_t i = 0; i < input.size(); ++i )
+        input[i] = static_cast<int>( i );
+
+    auto twice = []( int x ) -> expected<long, int>
+    {
+        if ( x % 300 == 299 )
+            return make_unexpected( x );
+        return 2L * x;
+    };
+
+    auto all = []( int x ) -> expected<long, int> { return x; };
+
+    for ( std::size_t threads = 1; threads <= 8; threads *= 2 )
+    {
+        expected< std::vector<long>, int > ea = transform_collect( input, all, threads );
+
+        EXPECT( ea.has_value() );
+
+        const std::vector<long> va = std::move( ea ).value_or( std::vector<long>() );
+
+        EXPECT( va.size() == input.size() );
+        EXPECT( va.at( 999 ) == 999 );
+
+        const std::vector<long> vp = transform_collect( input.begin(), input.begin() + 200, twice, threads ).value_or( std::vector<long>() );
+
+        EXPECT( vp.size() == 200u );
+        EXPECT( vp.at( 100 ) == 200 );
+        EXPECT( transform_collect( input, twice, threads ).error() == 299 );
+    }
+
+    EXPECT( transform_collect( std::vector<int>(), all ) == std::vector<long>() );
+#else
+    EXPECT( !!"transform_collect() is not available (nsel_CONFIG_PARALLEL_COLLECT is 0)." );
+#endif
+}
+
+// end of file
@@ -0,0 +1,369 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Exact number of constructions, copies, moves, assignments and destructions
+// of value and error per operation of expected<T,E> and expected<void,E>.
+//
+// Each row of a table performs one operation on an expected that is set up
+// beforehand and compares the counts of the instrumented value and error type
+// with the counts in the table, so that any additional copy or move fails.
+//
+// The counts assume copy elision (-felide-constructors, see CMakeLists.txt),
+// for them to be the same for every C++ standard.
+
+#include "expected-main.t.hpp"
+
+#include <sstream>
+#include <string>
+
+#if !nsel_USES_STD_EXPECTED
+
+using namespace nonstd;
+
+namespace {
+
+// counts of the operations of an instrumented type:
+
+struct counts
+{
+    int construct;      // from int, or default
+    int copy;
+    int move;
+    int copy_assign;
+    int move_assign;
+    int destroy;
+};
+
+template< typename Tag >
+struct counted
+{
+    int v;
+
+    static counts & tally() { static counts c = {}; return c; }
+
+    counted()                        : v( 0 )       { ++tally().construct; }
+    counted( int v_ )                : v( v_ )      { ++tally().construct; }
+    counted( counted const & other ) : v( other.v ) { ++tally().copy; }
+    counted( counted && other ) noexcept : v( other.v ) { ++tally().move; }
+    ~counted()                                      { ++tally().destroy; }
+
+    counted & operator=( counted const & other )    { v = other.v; ++tally().copy_assign; return *this; }
+    counted & operator=( counted && other ) noexcept { v = other.v; ++tally().move_assign; return *this; }
+};
+
+struct value_tag {};
+struct error_tag {};
+
+using Value = counted< value_tag >;
+using Error = counted< error_tag >;
+
+using EX = expected< Value, Error >;
+using EV = expected< void,  Error >;
+
+struct tallies
+{
+    counts value;
+    counts error;
+};
+
+// counts of the operations performed by f, which must destroy what it creates:
+
+template< typename F >
+tallies measure( F f )
+{
+    Value::tally() = counts();
+    Error::tally() = counts();
+
+    f();
+
+    const tallies result = { Value::tally(), Error::tally() };
+    return result;
+}
+
+struct row
+{
+    char const * name;
+    counts value;
+    counts error;
+    tallies (*run)();
+};
+
+std::string to_string( counts const & c )
+{
+    std::ostringstream os;
+    os << "construct:" << c.construct << " copy:" << c.copy << " move:" << c.move
+       << " copy=:" << c.copy_assign << " move=:" << c.move_assign << " destroy:" << c.destroy;
+    return os.str();
+}
+
+std::string report( char const * name, counts const & value, counts const & error )
+{
+    return std::string( name ) + ": value{ " + to_string( value ) + " } error{ " + to_string( error ) + " }";
+}
+
+template< std::size_t N >
+int check( lest::env & lest_env, row const (&rows)[N] )
+{
+    for ( auto const & r : rows )
+    {
+        const tallies actual = r.run();
+
+        EXPECT( report( r.name, actual.value, actual.error ) == report( r.name, r.value, r.error ) );
+    }
+    return 0;
+}
+
+// functions for the monadic operations:
+
+#if nsel_P2505R >= 3
+
+EX  then_value( Value const & v )      { return EX( in_place, v.v + 1 ); }
+EX  else_value( Error const & e )      { return EX( in_place, e.v + 1 ); }
+int transform_value( Value const & v ) { return v.v + 1; }
+int transform_error( Error const & e ) { return e.v + 1; }
+
+EV  then_void()                        { return EV(); }
+EV  else_void( Error const & e )       { return EV( unexpect, e.v + 1 ); }
+int transform_void()                   { return 1; }
+
+#endif // nsel_P2505R >= 3
+
+// The counts per row: construct, copy, move, copy-assign, move-assign, destroy.
+
+const counts none = {};
+
+} // anonymous namespace
+
+CASE( "expected: Constructs value and error without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "default",                                { 1, 0, 0, 0, 0, 1 }, none                 , []{ return measure( []{ EX x; } ); } },
+        { "copy, value",                            { 0, 1, 0, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ EX x( a ); } ); } },
+        { "copy, error",                            none                 , { 0, 1, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ EX x( a ); } ); } },
+        { "move, value",                            { 0, 0, 1, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ EX x( std::move( a ) ); } ); } },
+        { "move, error",                            none                 , { 0, 0, 1, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ EX x( std::move( a ) ); } ); } },
+        { "from value, lvalue",                     { 0, 1, 0, 0, 0, 1 }, none                 , []{ Value v( 1 ); return measure( [&]{ EX x( v ); } ); } },
+        { "from value, rvalue",                     { 0, 0, 1, 0, 0, 1 }, none                 , []{ Value v( 1 ); return measure( [&]{ EX x( std::move( v ) ); } ); } },
+        { "from int",                               { 1, 0, 0, 0, 0, 1 }, none                 , []{ return measure( []{ EX x( 1 ); } ); } },
+        { "from unexpected, lvalue",                none                 , { 0, 1, 0, 0, 0, 1 }, []{ unexpected_type<Error> u( 1 ); return measure( [&]{ EX x( u ); } ); } },
+        { "from unexpected, rvalue",                none                 , { 0, 0, 1, 0, 0, 1 }, []{ unexpected_type<Error> u( 1 ); return measure( [&]{ EX x( std::move( u ) ); } ); } },
+        { "in place, value",                        { 1, 0, 0, 0, 0, 1 }, none                 , []{ return measure( []{ EX x( in_place, 1 ); } ); } },
+        { "in place, error",                        none                 , { 1, 0, 0, 0, 0, 1 }, []{ return measure( []{ EX x( unexpect, 1 ); } ); } },
+        { "from expected<int,int>, value",          { 1, 0, 0, 0, 0, 1 }, none                 , []{ expected<int, int> a( 1 ); return measure( [&]{ EX x( a ); } ); } },
+        { "from expected<int,int>, error",          none                 , { 1, 0, 0, 0, 0, 1 }, []{ expected<int, int> a( make_unexpected( 1 ) ); return measure( [&]{ EX x( a ); } ); } },
+    };
+
+    check( lest_env, rows );
+}
+
+CASE( "expected: Assigns value and error without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "copy, value to value",                   { 0, 0, 0, 1, 0, 0 }, none                 , []{ EX a( in_place, 1 ); EX b( in_place, 2 ); return measure( [&]{ a = b; } ); } },
+        { "copy, error to value",                   { 0, 0, 0, 0, 0, 1 }, { 0, 1, 1, 0, 0, 1 }, []{ EX a( in_place, 1 ); EX b( unexpect, 2 ); return measure( [&]{ a = b; } ); } },
+        { "copy, value to error",                   { 0, 1, 1, 0, 0, 1 }, { 0, 0, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); EX b( in_place, 2 ); return measure( [&]{ a = b; } ); } },
+        { "copy, error to error",                   none                 , { 0, 0, 0, 1, 0, 0 }, []{ EX a( unexpect, 1 ); EX b( unexpect, 2 ); return measure( [&]{ a = b; } ); } },
+        { "move, value to value",                   { 0, 0, 0, 0, 1, 0 }, none                 , []{ EX a( in_place, 1 ); EX b( in_place, 2 ); return measure( [&]{ a = std::move( b ); } ); } },
+        { "move, error to value",                   { 0, 0, 0, 0, 0, 1 }, { 0, 0, 1, 0, 0, 0 }, []{ EX a( in_place, 1 ); EX b( unexpect, 2 ); return measure( [&]{ a = std::move( b ); } ); } },
+        { "move, value to error",                   { 0, 0, 1, 0, 0, 0 }, { 0, 0, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); EX b( in_place, 2 ); return measure( [&]{ a = std::move( b ); } ); } },
+        { "move, error to error",                   none                 , { 0, 0, 0, 0, 1, 0 }, []{ EX a( unexpect, 1 ); EX b( unexpect, 2 ); return measure( [&]{ a = std::move( b ); } ); } },
+        { "lvalue value, to value",                 { 0, 0, 0, 1, 0, 0 }, none                 , []{ EX a( in_place, 1 ); Value v( 2 ); return measure( [&]{ a = v; } ); } },
+        { "lvalue value, to error",                 { 0, 1, 1, 0, 0, 1 }, { 0, 0, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); Value v( 2 ); return measure( [&]{ a = v; } ); } },
+        { "rvalue value, to value",                 { 0, 0, 0, 0, 1, 0 }, none                 , []{ EX a( in_place, 1 ); Value v( 2 ); return measure( [&]{ a = std::move( v ); } ); } },
+        { "rvalue value, to error",                 { 0, 0, 1, 0, 0, 0 }, { 0, 0, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); Value v( 2 ); return measure( [&]{ a = std::move( v ); } ); } },
+        { "lvalue unexpected, to value",            { 0, 0, 0, 0, 0, 1 }, { 0, 1, 1, 0, 0, 1 }, []{ EX a( in_place, 1 ); unexpected_type<Error> u( 2 ); return measure( [&]{ a = u; } ); } },
+        { "lvalue unexpected, to error",            none                 , { 0, 0, 0, 1, 0, 0 }, []{ EX a( unexpect, 1 ); unexpected_type<Error> u( 2 ); return measure( [&]{ a = u; } ); } },
+        { "rvalue unexpected, to value",            { 0, 0, 0, 0, 0, 1 }, { 0, 0, 1, 0, 0, 0 }, []{ EX a( in_place, 1 ); unexpected_type<Error> u( 2 ); return measure( [&]{ a = std::move( u ); } ); } },
+        { "rvalue unexpected, to error",            none                 , { 0, 0, 0, 0, 1, 0 }, []{ EX a( unexpect, 1 ); unexpected_type<Error> u( 2 ); return measure( [&]{ a = std::move( u ); } ); } },
+    };
+
+    check( lest_env, rows );
+}
+
+CASE( "expected: Swaps and emplaces value and error without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "swap, value with value",                 { 0, 0, 1, 0, 2, 1 }, none                 , []{ EX a( in_place, 1 ); EX b( in_place, 2 ); return measure( [&]{ a.swap( b ); } ); } },
+        { "swap, value with error",                 { 0, 0, 1, 0, 0, 1 }, { 0, 0, 2, 0, 0, 2 }, []{ EX a( in_place, 1 ); EX b( unexpect, 2 ); return measure( [&]{ a.swap( b ); } ); } },
+        { "swap, error with value",                 { 0, 0, 1, 0, 0, 1 }, { 0, 0, 2, 0, 0, 2 }, []{ EX a( unexpect, 1 ); EX b( in_place, 2 ); return measure( [&]{ a.swap( b ); } ); } },
+        { "swap, error with error",                 none                 , { 0, 0, 1, 0, 2, 1 }, []{ EX a( unexpect, 1 ); EX b( unexpect, 2 ); return measure( [&]{ a.swap( b ); } ); } },
+        { "emplace, on value",                      { 1, 0, 1, 0, 0, 2 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ a.emplace( 2 ); } ); } },
+        { "emplace, on error",                      { 1, 0, 1, 0, 0, 1 }, { 0, 0, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ a.emplace( 2 ); } ); } },
+    };
+
+    check( lest_env, rows );
+}
+
+CASE( "expected: Provides value or error without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "value_or() const &, value",              { 0, 1, 0, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ Value r = a.value_or( 2 ); } ); } },
+        { "value_or() const &, error",              { 1, 0, 0, 0, 0, 1 }, none                 , []{ EX a( unexpect, 1 ); return measure( [&]{ Value r = a.value_or( 2 ); } ); } },
+        { "value_or() &&, value",                   { 0, 0, 1, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ Value r = std::move( a ).value_or( 2 ); } ); } },
+        { "value_or() &&, error",                   { 1, 0, 0, 0, 0, 1 }, none                 , []{ EX a( unexpect, 1 ); return measure( [&]{ Value r = std::move( a ).value_or( 2 ); } ); } },
+#if nsel_P2505R >= 4
+        { "error_or() const &, value",              none                 , { 1, 0, 0, 0, 0, 1 }, []{ EX a( in_place, 1 ); return measure( [&]{ Error r = a.error_or( 2 ); } ); } },
+        { "error_or() const &, error",              none                 , { 0, 1, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ Error r = a.error_or( 2 ); } ); } },
+        { "error_or() &&, value",                   none                 , { 1, 0, 0, 0, 0, 1 }, []{ EX a( in_place, 1 ); return measure( [&]{ Error r = std::move( a ).error_or( 2 ); } ); } },
+        { "error_or() &&, error",                   none                 , { 0, 0, 1, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ Error r = std::move( a ).error_or( 2 ); } ); } },
+        { "void: error_or() const &, value",        none                 , { 1, 0, 0, 0, 0, 1 }, []{ EV a; return measure( [&]{ Error r = a.error_or( 2 ); } ); } },
+        { "void: error_or() const &, error",        none                 , { 0, 1, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ Error r = a.error_or( 2 ); } ); } },
+        { "void: error_or() &&, value",             none                 , { 1, 0, 0, 0, 0, 1 }, []{ EV a; return measure( [&]{ Error r = std::move( a ).error_or( 2 ); } ); } },
+        { "void: error_or() &&, error",             none                 , { 0, 0, 1, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ Error r = std::move( a ).error_or( 2 ); } ); } },
+#endif
+    };
+
+    check( lest_env, rows );
+}
+
+#if nsel_P2505R >= 3
+
+CASE( "expected: Performs the monadic operations without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "and_then() &, value",                    { 1, 0, 0, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) a.and_then( then_value ); } ); } },
+        { "and_then() &, error",                    none                 , { 0, 1, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ (void) a.and_then( then_value ); } ); } },
+        { "and_then() const &, value",              { 1, 0, 0, 0, 0, 1 }, none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) a.and_then( then_value ); } ); } },
+        { "and_then() const &, error",              none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) a.and_then( then_value ); } ); } },
+        { "and_then() &&, value",                   { 1, 0, 0, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).and_then( then_value ); } ); } },
+        { "and_then() &&, error",                   none                 , { 0, 0, 1, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).and_then( then_value ); } ); } },
+        { "and_then() const &&, value",             { 1, 0, 0, 0, 0, 1 }, none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).and_then( then_value ); } ); } },
+        { "and_then() const &&, error",             none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).and_then( then_value ); } ); } },
+
+        { "or_else() &, value",                     { 0, 1, 0, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) a.or_else( else_value ); } ); } },
+        { "or_else() &, error",                     { 1, 0, 0, 0, 0, 1 }, none                 , []{ EX a( unexpect, 1 ); return measure( [&]{ (void) a.or_else( else_value ); } ); } },
+        { "or_else() const &, value",               { 0, 1, 0, 0, 0, 1 }, none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) a.or_else( else_value ); } ); } },
+        { "or_else() const &, error",               { 1, 0, 0, 0, 0, 1 }, none                 , []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) a.or_else( else_value ); } ); } },
+        { "or_else() &&, value",                    { 0, 0, 1, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).or_else( else_value ); } ); } },
+        { "or_else() &&, error",                    { 1, 0, 0, 0, 0, 1 }, none                 , []{ EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).or_else( else_value ); } ); } },
+        { "or_else() const &&, value",              { 0, 1, 0, 0, 0, 1 }, none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).or_else( else_value ); } ); } },
+        { "or_else() const &&, error",              { 1, 0, 0, 0, 0, 1 }, none                 , []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).or_else( else_value ); } ); } },
+
+        { "transform() &, value",                   none                 , none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) a.transform( transform_value ); } ); } },
+        { "transform() &, error",                   none                 , { 0, 1, 0, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ (void) a.transform( transform_value ); } ); } },
+        { "transform() const &, value",             none                 , none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) a.transform( transform_value ); } ); } },
+        { "transform() const &, error",             none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) a.transform( transform_value ); } ); } },
+        { "transform() &&, value",                  none                 , none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).transform( transform_value ); } ); } },
+        { "transform() &&, error",                  none                 , { 0, 0, 1, 0, 0, 1 }, []{ EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform( transform_value ); } ); } },
+        { "transform() const &&, value",            none                 , none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).transform( transform_value ); } ); } },
+        { "transform() const &&, error",            none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform( transform_value ); } ); } },
+
+        { "transform_error() &, value",             { 0, 1, 0, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() &, error",             none                 , none                 , []{ EX a( unexpect, 1 ); return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() const &, value",       { 0, 1, 0, 0, 0, 1 }, none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() const &, error",       none                 , none                 , []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() &&, value",            { 0, 0, 1, 0, 0, 1 }, none                 , []{ EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+        { "transform_error() &&, error",            none                 , none                 , []{ EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+        { "transform_error() const &&, value",      { 0, 1, 0, 0, 0, 1 }, none                 , []{ const EX a( in_place, 1 ); return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+        { "transform_error() const &&, error",      none                 , none                 , []{ const EX a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+    };
+
+    check( lest_env, rows );
+}
+
+#endif // nsel_P2505R >= 3
+
+CASE( "expected<void>: Constructs, assigns, swaps and emplaces the error without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "default",                                none                 , none                 , []{ return measure( []{ EV x; } ); } },
+        { "copy, value",                            none                 , none                 , []{ EV a; return measure( [&]{ EV x( a ); } ); } },
+        { "copy, error",                            none                 , { 0, 1, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ EV x( a ); } ); } },
+        { "move, value",                            none                 , none                 , []{ EV a; return measure( [&]{ EV x( std::move( a ) ); } ); } },
+        { "move, error",                            none                 , { 0, 0, 1, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ EV x( std::move( a ) ); } ); } },
+        { "from unexpected, lvalue",                none                 , { 0, 1, 0, 0, 0, 1 }, []{ unexpected_type<Error> u( 1 ); return measure( [&]{ EV x( u ); } ); } },
+        { "from unexpected, rvalue",                none                 , { 0, 0, 1, 0, 0, 1 }, []{ unexpected_type<Error> u( 1 ); return measure( [&]{ EV x( std::move( u ) ); } ); } },
+        { "in place, error",                        none                 , { 1, 0, 0, 0, 0, 1 }, []{ return measure( []{ EV x( unexpect, 1 ); } ); } },
+
+        { "copy-assign, value to value",            none                 , none                 , []{ EV a; EV b; return measure( [&]{ a = b; } ); } },
+        { "copy-assign, error to value",            none                 , { 0, 1, 0, 0, 0, 0 }, []{ EV a; EV b( unexpect, 2 ); return measure( [&]{ a = b; } ); } },
+        { "copy-assign, value to error",            none                 , { 0, 0, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); EV b; return measure( [&]{ a = b; } ); } },
+        { "copy-assign, error to error",            none                 , { 0, 0, 0, 1, 0, 0 }, []{ EV a( unexpect, 1 ); EV b( unexpect, 2 ); return measure( [&]{ a = b; } ); } },
+        { "move-assign, value to value",            none                 , none                 , []{ EV a; EV b; return measure( [&]{ a = std::move( b ); } ); } },
+        { "move-assign, error to value",            none                 , { 0, 0, 1, 0, 0, 0 }, []{ EV a; EV b( unexpect, 2 ); return measure( [&]{ a = std::move( b ); } ); } },
+        { "move-assign, value to error",            none                 , { 0, 0, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); EV b; return measure( [&]{ a = std::move( b ); } ); } },
+        { "move-assign, error to error",            none                 , { 0, 0, 0, 0, 1, 0 }, []{ EV a( unexpect, 1 ); EV b( unexpect, 2 ); return measure( [&]{ a = std::move( b ); } ); } },
+        { "assign lvalue unexpected, to value",     none                 , { 0, 1, 0, 0, 0, 0 }, []{ EV a; unexpected_type<Error> u( 2 ); return measure( [&]{ a = u; } ); } },
+        { "assign lvalue unexpected, to error",     none                 , { 0, 0, 0, 1, 0, 0 }, []{ EV a( unexpect, 1 ); unexpected_type<Error> u( 2 ); return measure( [&]{ a = u; } ); } },
+        { "assign rvalue unexpected, to value",     none                 , { 0, 0, 1, 0, 0, 0 }, []{ EV a; unexpected_type<Error> u( 2 ); return measure( [&]{ a = std::move( u ); } ); } },
+        { "assign rvalue unexpected, to error",     none                 , { 0, 0, 0, 0, 1, 0 }, []{ EV a( unexpect, 1 ); unexpected_type<Error> u( 2 ); return measure( [&]{ a = std::move( u ); } ); } },
+
+        { "swap, value with value",                 none                 , none                 , []{ EV a; EV b; return measure( [&]{ a.swap( b ); } ); } },
+        { "swap, value with error",                 none                 , { 0, 0, 1, 0, 0, 1 }, []{ EV a; EV b( unexpect, 2 ); return measure( [&]{ a.swap( b ); } ); } },
+        { "swap, error with value",                 none                 , { 0, 0, 1, 0, 0, 1 }, []{ EV a( unexpect, 1 ); EV b; return measure( [&]{ a.swap( b ); } ); } },
+        { "swap, error with error",                 none                 , { 0, 0, 1, 0, 2, 1 }, []{ EV a( unexpect, 1 ); EV b( unexpect, 2 ); return measure( [&]{ a.swap( b ); } ); } },
+        { "emplace, on value",                      none                 , none                 , []{ EV a; return measure( [&]{ a.emplace(); } ); } },
+        { "emplace, on error",                      none                 , { 0, 0, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ a.emplace(); } ); } },
+    };
+
+    check( lest_env, rows );
+}
+
+#if nsel_P2505R >= 3
+
+CASE( "expected<void>: Performs the monadic operations without needless copies or moves" "[counts]" )
+{
+    static const row rows[] =
+    {
+        //                                           value                  error
+        { "and_then() &, value",                    none                 , none                 , []{ EV a; return measure( [&]{ (void) a.and_then( then_void ); } ); } },
+        { "and_then() &, error",                    none                 , { 0, 1, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ (void) a.and_then( then_void ); } ); } },
+        { "and_then() const &, value",              none                 , none                 , []{ const EV a; return measure( [&]{ (void) a.and_then( then_void ); } ); } },
+        { "and_then() const &, error",              none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) a.and_then( then_void ); } ); } },
+        { "and_then() &&, value",                   none                 , none                 , []{ EV a; return measure( [&]{ (void) std::move( a ).and_then( then_void ); } ); } },
+        { "and_then() &&, error",                   none                 , { 0, 0, 1, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).and_then( then_void ); } ); } },
+        { "and_then() const &&, value",             none                 , none                 , []{ const EV a; return measure( [&]{ (void) std::move( a ).and_then( then_void ); } ); } },
+        { "and_then() const &&, error",             none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).and_then( then_void ); } ); } },
+
+        { "or_else() &, value",                     none                 , none                 , []{ EV a; return measure( [&]{ (void) a.or_else( else_void ); } ); } },
+        { "or_else() &, error",                     none                 , { 1, 0, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ (void) a.or_else( else_void ); } ); } },
+        { "or_else() const &, value",               none                 , none                 , []{ const EV a; return measure( [&]{ (void) a.or_else( else_void ); } ); } },
+        { "or_else() const &, error",               none                 , { 1, 0, 0, 0, 0, 1 }, []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) a.or_else( else_void ); } ); } },
+        { "or_else() &&, value",                    none                 , none                 , []{ EV a; return measure( [&]{ (void) std::move( a ).or_else( else_void ); } ); } },
+        { "or_else() &&, error",                    none                 , { 1, 0, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).or_else( else_void ); } ); } },
+        { "or_else() const &&, value",              none                 , none                 , []{ const EV a; return measure( [&]{ (void) std::move( a ).or_else( else_void ); } ); } },
+        { "or_else() const &&, error",              none                 , { 1, 0, 0, 0, 0, 1 }, []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).or_else( else_void ); } ); } },
+
+        { "transform() &, value",                   none                 , none                 , []{ EV a; return measure( [&]{ (void) a.transform( transform_void ); } ); } },
+        { "transform() &, error",                   none                 , { 0, 1, 0, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ (void) a.transform( transform_void ); } ); } },
+        { "transform() const &, value",             none                 , none                 , []{ const EV a; return measure( [&]{ (void) a.transform( transform_void ); } ); } },
+        { "transform() const &, error",             none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) a.transform( transform_void ); } ); } },
+        { "transform() &&, value",                  none                 , none                 , []{ EV a; return measure( [&]{ (void) std::move( a ).transform( transform_void ); } ); } },
+        { "transform() &&, error",                  none                 , { 0, 0, 1, 0, 0, 1 }, []{ EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform( transform_void ); } ); } },
+        { "transform() const &&, value",            none                 , none                 , []{ const EV a; return measure( [&]{ (void) std::move( a ).transform( transform_void ); } ); } },
+        { "transform() const &&, error",            none                 , { 0, 1, 0, 0, 0, 1 }, []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform( transform_void ); } ); } },
+
+        { "transform_error() &, value",             none                 , none                 , []{ EV a; return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() &, error",             none                 , none                 , []{ EV a( unexpect, 1 ); return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() const &, value",       none                 , none                 , []{ const EV a; return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() const &, error",       none                 , none                 , []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) a.transform_error( transform_error ); } ); } },
+        { "transform_error() &&, value",            none                 , none                 , []{ EV a; return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+        { "transform_error() &&, error",            none                 , none                 , []{ EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+        { "transform_error() const &&, value",      none                 , none                 , []{ const EV a; return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+        { "transform_error() const &&, error",      none                 , none                 , []{ const EV a( unexpect, 1 ); return measure( [&]{ (void) std::move( a ).transform_error( transform_error ); } ); } },
+    };
+
+    check( lest_env, rows );
+}
+
+#endif // nsel_P2505R >= 3
+
+#endif // !nsel_USES_STD_EXPECTED
+
+// end of file
@@ -0,0 +1,156 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Layout of common instantiations of expected<T,E>, see nonstd/expected_layout.hpp:
+// a change of the storage of expected changes these.
+
+#include "expected-main.t.hpp"
+#include "nonstd/expected_layout.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#if !nsel_USES_STD_EXPECTED
+
+using namespace nonstd;
+
+namespace {
+
+// types with a niche, see niche_traits:
+
+struct Slot
+{
+    int index;
+    unsigned char tag;      // never 0xFF
+};
+
+struct Handle
+{
+    void * pointer;         // never null
+};
+
+} // anonymous namespace
+
+namespace nonstd { namespace expected_lite {
+
+template<> struct niche_traits< Slot   > : niche_byte< offsetof( Slot, tag ) > {};
+template<> struct niche_traits< Handle > : niche_null_pointer< 0 > {};
+
+}} // namespace nonstd::expected_lite
+
+namespace {
+
+// compare all members, show the layout on failure:
+
+std::string layout_text( expected_layout const & layout )
+{
+    std::ostringstream os;
+    os << layout;
+    return os.str();
+}
+
+std::string layout_text(
+    std::size_t size, std::size_t align, std::size_t value_size, std::size_t value_offset, std::size_t error_size, std::size_t error_offset
+    , layout_discriminant discriminant, std::size_t discriminant_size, std::size_t discriminant_offset, std::size_t padding )
+{
+    const expected_layout layout = { size, align, value_size, value_offset, error_size, error_offset, discriminant, discriminant_size, discriminant_offset, padding };
+    return layout_text( layout );
+}
+
+template< typename T >
+int byte_at( T const & object, std::size_t offset )
+{
+    return reinterpret_cast<unsigned char const *>( std11::addressof( object ) )[ offset ];
+}
+
+constexpr std::size_t round_up( std::size_t n, std::size_t a )
+{
+    return ( n + a - 1 ) / a * a;
+}
+
+} // anonymous namespace
+
+// the layout is available at compile time:
+
+static_assert( layout_report<int, std::errc>().size == sizeof( expected<int, std::errc> ), "layout_report() is constexpr" );
+
+CASE( "layout_report(): Reports the layout with the discriminant in a flag after the union" "[layout]" )
+{
+    const auto flag = layout_discriminant::flag;
+
+    EXPECT( layout_text( layout_report<char  , char     >() ) == layout_text(  2, 1,  1, 0,  1, 0, flag, 1,  1, 0 ) );
+    EXPECT( layout_text( layout_report<bool  , std::errc>() ) == layout_text(  8, 4,  1, 0,  4, 0, flag, 1,  4, 3 ) );
+    EXPECT( layout_text( layout_report<int   , std::errc>() ) == layout_text(  8, 4,  4, 0,  4, 0, flag, 1,  4, 3 ) );
+    EXPECT( layout_text( layout_report<int   , int      >() ) == layout_text(  8, 4,  4, 0,  4, 0, flag, 1,  4, 3 ) );
+    EXPECT( layout_text( layout_report<double, int      >() ) == layout_text( 16, 8,  8, 0,  4, 0, flag, 1,  8, 7 ) );
+    EXPECT( layout_text( layout_report<int * , std::errc>() ) == layout_text( 2 * sizeof( int * ), alignof( int * ), sizeof( int * ), 0, 4, 0, flag, 1, sizeof( int * ), sizeof( int * ) - 1 ) );
+    EXPECT( layout_text( layout_report<void  , int      >() ) == layout_text(  8, 4,  0, 0,  4, 0, flag, 1,  4, 3 ) );
+    EXPECT( layout_text( layout_report<void  , char     >() ) == layout_text(  2, 1,  0, 0,  1, 0, flag, 1,  1, 0 ) );
+
+    // the flag is where the report says:
+
+    const std::size_t offset = layout_report<double, int>().discriminant_offset;
+
+    EXPECT( byte_at( expected<double, int>( 3.14 ), offset ) == 1 );
+    EXPECT( byte_at( expected<double, int>( make_unexpected( 7 ) ), offset ) == 0 );
+}
+
+CASE( "layout_report(): Reports the layout of expected with a library type" "[layout]" )
+{
+    const auto flag = layout_discriminant::flag;
+    const std::size_t string_size = sizeof( std::string );
+    const std::size_t code_size   = sizeof( std::error_code );
+
+    EXPECT( layout_text( layout_report<std::string, int>() )
+        == layout_text( round_up( string_size + 1, alignof( std::string ) ), alignof( std::string ), string_size, 0, sizeof( int ), 0, flag, 1, string_size, round_up( string_size + 1, alignof( std::string ) ) - string_size - 1 ) );
+
+#if nsel_CONFIG_NICHE_ERROR_CODE
+    const std::size_t n = sizeof( void * );
+
+    EXPECT( layout_text( layout_report<int , std::error_code>() ) == layout_text( code_size, alignof( std::error_code ), sizeof( int ), 0, code_size, 0, layout_discriminant::niche_in_error, n, code_size - n, 0 ) );
+    EXPECT( layout_text( layout_report<void, std::error_code>() ) == layout_text( code_size, alignof( std::error_code ), 0, 0, code_size, 0, layout_discriminant::niche_in_error, n, code_size - n, 0 ) );
+#else
+    EXPECT( layout_text( layout_report<int, std::error_code>() )
+        == layout_text( round_up( code_size + 1, alignof( std::error_code ) ), alignof( std::error_code ), sizeof( int ), 0, code_size, 0, flag, 1, code_size, round_up( code_size + 1, alignof( std::error_code ) ) - code_size - 1 ) );
+    EXPECT( layout_text( layout_report<void, std::error_code>() )
+        == layout_text( round_up( code_size + 1, alignof( std::error_code ) ), alignof( std::error_code ), 0, 0, code_size, 0, flag, 1, code_size, round_up( code_size + 1, alignof( std::error_code ) ) - code_size - 1 ) );
+#endif
+}
+
+CASE( "layout_report(): Reports the layout with the discriminant in a niche" "[layout]" )
+{
+    EXPECT( layout_text( layout_report<Slot , short>() ) == layout_text( 8, 4, 8, 0, 2, 0, layout_discriminant::niche_in_value, 1, 4, 0 ) );
+    EXPECT( layout_text( layout_report<short, Slot >() ) == layout_text( 8, 4, 2, 0, 8, 0, layout_discriminant::niche_in_error, 1, 4, 0 ) );
+    EXPECT( layout_text( layout_report<void , Slot >() ) == layout_text( 8, 4, 0, 0, 8, 0, layout_discriminant::niche_in_error, 1, 4, 0 ) );
+
+    // the int fits before the niche of Slot, but nothing fits beside the niche of Handle:
+
+    const std::size_t n = sizeof( void * );
+
+    EXPECT( layout_text( layout_report<Slot  , int  >() ) == layout_text( 8, 4, 8, 0, 4, 0, layout_discriminant::niche_in_value, 1, 4, 0 ) );
+    EXPECT( layout_text( layout_report<Handle, short>() ) == layout_text( 2 * n, n, n, 0, 2, 0, layout_discriminant::flag, 1, n, n - 1 ) );
+}
+
+CASE( "layout_report(): Prints the layout of common instantiations" "[.layout]" )
+{
+    std::cout
+        << "expected<int, std::errc>:               " << layout_report<int        , std::errc      >() << "\n"
+        << "expected<double, int>:                  " << layout_report<double     , int            >() << "\n"
+        << "expected<int *, std::errc>:             " << layout_report<int *      , std::errc      >() << "\n"
+        << "expected<int, std::error_code>:         " << layout_report<int        , std::error_code>() << "\n"
+        << "expected<std::string, int>:             " << layout_report<std::string, int            >() << "\n"
+        << "expected<std::string, std::error_code>: " << layout_report<std::string, std::error_code>() << "\n"
+        << "expected<void, int>:                    " << layout_report<void       , int            >() << "\n"
+        << "expected<void, std::error_code>:        " << layout_report<void       , std::error_code>() << "\n";
+}
+
+#endif // !nsel_USES_STD_EXPECTED
+
+// end of file
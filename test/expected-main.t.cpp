@@ -5,6 +5,10 @@
 // Distributed under the Boost Software License, Version 1.0.
 // (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+// forward declarations first, as a header that only names expected would:
+
+#include "nonstd/expected_fwd.hpp"
+
 #include "expected-main.t.hpp"
 
 #define expected_PRESENT( x ) \
@@ -0,0 +1,95 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Use expected-lite via module nonstd.expected (C++20). The module doesn't
+// export macros, configuration macros are visible if the module's build
+// defines them publicly.
+
+#include "lest.hpp"
+
+#include <string>
+#include <vector>
+
+import nonstd.expected;
+
+using namespace nonstd;
+
+#define CASE( name ) lest_CASE( specification(), name )
+
+static lest::tests & specification()
+{
+    static lest::tests tests;
+    return tests;
+}
+
+CASE( "module: Allows to construct and observe an expected value and error" )
+{
+    expected<int, std::string> v( 42 );
+    expected<int, std::string> e( unexpect, "error" );
+
+    EXPECT( v.has_value() );
+    EXPECT( *v == 42 );
+    EXPECT( v.value() == 42 );
+    EXPECT_NOT( e.has_value() );
+    EXPECT( e.error() == "error" );
+    EXPECT( e.value_or( 7 ) == 7 );
+}
+
+CASE( "module: Allows to compare, swap and to create an unexpected" )
+{
+    expected<int, int> a( 1 );
+    expected<int, int> b = make_unexpected( 2 );
+
+    EXPECT( a == 1 );
+    EXPECT( b == unexpected_type<int>( 2 ) );
+    EXPECT( a != b );
+
+    swap( a, b );
+
+    EXPECT( a.error() == 2 );
+    EXPECT( *b == 1 );
+}
+
+CASE( "module: Throws bad_expected_access on access to the value of an error" )
+{
+#if !defined( nsel_CONFIG_NO_EXCEPTIONS ) || !nsel_CONFIG_NO_EXCEPTIONS
+    expected<int, int> e( unexpect, 7 );
+
+    EXPECT_THROWS_AS( e.value(), bad_expected_access<int> );
+#else
+    EXPECT( !!"bad_expected_access is not available (nsel_CONFIG_NO_EXCEPTIONS)" );
+#endif
+}
+
+CASE( "module: Allows to use the monadic operations" )
+{
+#if !defined( nsel_P2505R ) || nsel_P2505R >= 3
+    expected<int, int> v( 2 );
+
+    auto r = v.and_then( []( int x ) { return expected<int, int>( 2 * x ); } )
+              .transform( []( int x ) { return std::to_string( x ); } );
+
+    EXPECT( *r == "4" );
+#else
+    EXPECT( !!"monadic operations are not available (nsel_P2505R < 3)" );
+#endif
+}
+
+CASE( "module: Allows to collect a range of expected" )
+{
+    std::vector< expected<int, int> > v{ expected<int, int>( 1 ), expected<int, int>( 2 ) };
+
+    auto r = sequence( v );
+
+    EXPECT( r.has_value() );
+    EXPECT( r->size() == 2u );
+}
+
+int main( int argc, char * argv[] )
+{
+    return lest::run( specification(), argc, argv );
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#ifndef TEST_EXPECTED_LITE_RESULTS_H_INCLUDED
+#define TEST_EXPECTED_LITE_RESULTS_H_INCLUDED
+
+// Fixture shared by the tests of expected_vector and sparse_expected_batch.
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace results {
+
+// n elements of a container of results with int values and std::string errors,
+// an error at each index that is a multiple of k:
+
+template< typename Results >
+Results make_results( std::size_t n, std::size_t k )
+{
+    Results r;
+
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        if ( i % k == 0 ) r.emplace_error_back( std::to_string( i ) );
+        else              r.emplace_back( static_cast<int>( i ) );
+    }
+    return r;
+}
+
+// a value or an error of which the construction may throw:
+
+struct Throws
+{
+    int v;
+
+    explicit Throws( int v_ ) : v( v_ )
+    {
+        if ( v < 0 )
+            throw std::runtime_error( "Throws" );
+    }
+};
+
+} // namespace results
+
+#endif // TEST_EXPECTED_LITE_RESULTS_H_INCLUDED
+
+// end of file
@@ -0,0 +1,206 @@
+// Copyright (c) 2016-2025 Martin Moene
+//
+// https://github.com/martinmoene/expected-lite
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "expected-main.t.hpp"
+#include "expected-results.t.hpp"
+#include "nonstd/expected_vector.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace nonstd;
+
+namespace {
+
+using EV = expected_vector<int, std::string>;
+
+using results::make_results;
+using results::Throws;
+
+} // anonymous namespace
+
+CASE( "expected_vector: Allows to append values and errors in order" "[vector]" )
+{
+    EV v;
+
+    v.push_back( 1 );
+    v.push_back( make_unexpected( std::string( "two" ) ) );
+    v.push_back( expected<int, std::string>( 3 ) );
+    v.push_back( expected<int, std::string>( unexpect, "four" ) );
+    v.emplace_back( 5 );
+    v.emplace_error_back( 3, 'x' );
+
+    EXPECT( v.size() == 6u );
+    EXPECT( v.count_values() == 3u );
+    EXPECT( v.count_errors() == 3u );
+
+    EXPECT(  v[0].has_value() );
+    EXPECT( !v[1].has_value() );
+    EXPECT(  v[2].has_value() );
+    EXPECT( !v[3].has_value() );
+    EXPECT(  v[4].has_value() );
+    EXPECT( !v[5].has_value() );
+
+    EXPECT( *v[0] == 1 );
+    EXPECT(  v[1].error() == "two" );
+    EXPECT( *v[2] == 3 );
+    EXPECT(  v[3].error() == "four" );
+    EXPECT( *v[4] == 5 );
+    EXPECT(  v[5].error() == "xxx" );
+}
+
+CASE( "expected_vector: Allows to access an element as a view like expected<T&,E&>" "[vector]" )
+{
+    EV v;
+
+    v.push_back( 42 );
+    v.push_back( make_unexpected( std::string( "error" ) ) );
+
+    EXPECT( v[0] );
+    EXPECT( v[0].value() == 42 );
+    EXPECT( v[0].value_or( 7 ) == 42 );
+    EXPECT( v[1].value_or( 7 ) ==  7 );
+    EXPECT( v[1].error() == "error" );
+
+    EXPECT_THROWS_AS( v[1].value(), bad_expected_access<std::string> );
+
+    // modify in place:
+
+    *v[0] = 43;
+    v[1].error() = "changed";
+
+    EXPECT( *v[0] == 43 );
+    EXPECT( v[1].error() == "changed" );
+
+    // copy to expected:
+
+    expected<int, std::string> a = v[0];
+    expected<int, std::string> b = v[1];
+
+    EXPECT( a.value() == 43 );
+    EXPECT( b.error() == "changed" );
+}
+
+CASE( "expected_vector: Allows to access an element of a const vector" "[vector]" )
+{
+    const EV v = make_results<EV>( 3, 2 );
+
+    EV::const_reference x = v[1];
+
+    EXPECT( *x == 1 );
+    EXPECT( v[0].error() == "0" );
+    EXPECT( v.at( 2 ).error() == "2" );
+}
+
+CASE( "expected_vector: Throws std::out_of_range from at() for an index beyond the end" "[vector]" )
+{
+    EV v = make_results<EV>( 3, 2 );
+
+    EXPECT_NO_THROW( v.at( 2 ) );
+    EXPECT_THROWS_AS( v.at( 3 ), std::out_of_range );
+}
+
+CASE( "expected_vector: Allows to iterate over all elements, over the values and over the errors" "[vector]" )
+{
+    EV v = make_results<EV>( 10, 3 );
+
+    std::vector<int> values;
+    std::vector<std::string> errors;
+    std::size_t count = 0;
+
+    for ( EV::reference x : v )
+    {
+        if ( x ) values.push_back( *x );
+        else     errors.push_back( x.error() );
+        ++count;
+    }
+
+    EXPECT( count == 10u );
+    EXPECT( values == ( std::vector<int>{ 1, 2, 4, 5, 7, 8 } ) );
+    EXPECT( errors == ( std::vector<std::string>{ "0", "3", "6", "9" } ) );
+
+    EXPECT( std::vector<int>( v.values().begin(), v.values().end() ) == values );
+    EXPECT( std::vector<std::string>( v.errors().begin(), v.errors().end() ) == errors );
+    EXPECT( v.values().size() == 6u );
+    EXPECT( v.errors().size() == 4u );
+
+    for ( int & x : v.values() )
+        x *= 10;
+
+    EXPECT( *v[8] == 80 );
+}
+
+CASE( "expected_vector: Counts the values in a range of elements across blocks of the bitmap" "[vector]" )
+{
+    EV v = make_results<EV>( 300, 7 );
+
+    std::size_t expected = 0;
+    for ( std::size_t i = 0; i < 300; ++i )
+    {
+        EXPECT( v.count_values( 0, i ) == expected );
+        EXPECT( v[i].has_value() == ( i % 7 != 0 ) );
+        expected += i % 7 != 0;
+    }
+
+    EXPECT( v.count_values( 0, 300 ) == v.count_values() );
+    EXPECT( v.count_values( 56, 70 ) == 12u );
+    EXPECT( v.count_values( 128, 128 ) == 0u );
+    EXPECT( v.count_values() + v.count_errors() == v.size() );
+}
+
+CASE( "expected_vector: Finds the first error at or after an index" "[vector]" )
+{
+    EV v = make_results<EV>( 300, 50 );
+
+    std::vector<std::size_t> found;
+
+    for ( std::size_t i = v.first_error(); i < v.size(); i = v.first_error( i + 1 ) )
+        found.push_back( i );
+
+    EXPECT( found == ( std::vector<std::size_t>{ 0, 50, 100, 150, 200, 250 } ) );
+    EXPECT( v.first_error( 251 ) == v.size() );
+    EXPECT( v.first_error( 300 ) == v.size() );
+    EXPECT( make_results<EV>( 200, 1000 ).first_error( 1 ) == 200u );
+    EXPECT( EV().first_error() == 0u );
+}
+
+CASE( "expected_vector: Leaves the vector unchanged if the construction of an element throws" "[vector]" )
+{
+    expected_vector<Throws, int> v;
+
+    for ( int i = 0; i < 64; ++i )
+        v.emplace_back( i );
+
+    EXPECT_THROWS_AS( v.emplace_back( -1 ), std::runtime_error );
+    EXPECT( v.size() == 64u );
+
+    v.emplace_error_back( 7 );
+    v.emplace_back( 65 );
+
+    EXPECT( v.size() == 66u );
+    EXPECT( v[64].error() == 7 );
+    EXPECT( v[65]->v == 65 );
+    EXPECT( v.count_values( 0, 66 ) == 65u );
+}
+
+CASE( "expected_vector: Allows to clear the vector" "[vector]" )
+{
+    EV v = make_results<EV>( 100, 3 );
+
+    v.clear();
+
+    EXPECT( v.empty() );
+    EXPECT( v.count_values() == 0u );
+    EXPECT( v.begin() == v.end() );
+
+    v.push_back( 1 );
+
+    EXPECT( *v[0] == 1 );
+}
+
+// end of file
@@ -10,6 +10,9 @@
 //   by Vicente J. Botet Escriba and Pierre Talbot, http:://wg21.link/p0323
 
 #include <cassert>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "expected-main.t.hpp"
 
 #ifndef nsel_CONFIG_CONFIRMS_COMPILATION_ERRORS
@@ -913,6 +916,283 @@ CASE( "expected: Allows to in-place-construct error from initializer_list" )
     EXPECT(  e.error().c       == 'a');
 }
 
+// x.x.4.2 expected<> destructor, triviality
+
+CASE( "expected: Is trivially copyable and destructible if T and E are" )
+{
+#if !nsel_USES_STD_EXPECTED && !nsel_HAVE_IS_TRIVIALLY_COPYABLE
+    EXPECT( !!"std::is_trivially_copyable is not available (no C++11 library support)." );
+#else
+    enum class Error { Bad };
+
+    using eie = expected<int, Error>;
+    using ede = expected<double, std::errc>;
+
+    EXPECT( std::is_trivially_destructible< eie >::value );
+    EXPECT( std::is_trivially_copy_constructible< eie >::value );
+    EXPECT( std::is_trivially_move_constructible< eie >::value );
+    EXPECT( std::is_trivially_copy_assignable< eie >::value );
+    EXPECT( std::is_trivially_move_assignable< eie >::value );
+    EXPECT( std::is_trivially_copyable< eie >::value );
+    EXPECT( std::is_trivially_copyable< ede >::value );
+#endif
+}
+
+CASE( "expected: Is not trivially copyable or destructible if T or E is not" )
+{
+#if !nsel_USES_STD_EXPECTED && !nsel_HAVE_IS_TRIVIALLY_COPYABLE
+    EXPECT( !!"std::is_trivially_copyable is not available (no C++11 library support)." );
+#else
+    using esi = expected<std::string, int>;
+    using eis = expected<int, std::string>;
+    using emi = expected<MoveOnly, int>;
+
+    EXPECT_NOT( std::is_trivially_destructible< esi >::value );
+    EXPECT_NOT( std::is_trivially_destructible< eis >::value );
+    EXPECT_NOT( std::is_trivially_copyable< esi >::value );
+    EXPECT_NOT( std::is_trivially_copyable< eis >::value );
+    EXPECT_NOT( std::is_trivially_copy_constructible< emi >::value );
+    EXPECT(     std::is_trivially_destructible< emi >::value );
+#endif
+}
+
+// x.x.4.2 expected<> storage, niche layout
+
+#if !nsel_USES_STD_EXPECTED
+
+namespace niche {
+
+// value with a state that is never 0xFF:
+
+struct Id
+{
+    int id;
+    unsigned char state;
+};
+
+// error with a kind that is never 0xFF:
+
+struct Error
+{
+    int code;
+    unsigned char kind;
+};
+
+// value that counts its instances:
+
+struct Tracked
+{
+    static int instances;
+
+    int v;
+
+    Tracked( int v_ ) : v( v_ ) { ++instances; }
+    Tracked( Tracked const & other ) : v( other.v ) { ++instances; }
+    ~Tracked() { --instances; }
+
+    Tracked & operator=( Tracked const & ) = default;
+};
+
+int Tracked::instances = 0;
+
+} // namespace niche
+
+namespace nonstd { namespace expected_lite {
+
+template<> struct niche_traits< niche::Id    > : niche_byte< offsetof( niche::Id   , state ) > {};
+template<> struct niche_traits< niche::Error > : niche_byte< offsetof( niche::Error, kind  ) > {};
+
+}} // namespace nonstd::expected_lite
+
+#endif // !nsel_USES_STD_EXPECTED
+
+CASE( "expected: Uses the niche of the value to hold the state, if available (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    using niche::Id;
+    using eic = expected<Id, char>;
+
+    EXPECT( sizeof( eic ) == sizeof( Id ) );
+
+    eic e{ Id{ 7, 0 } };
+    eic u{ unexpect, 'u' };
+
+    EXPECT( e.has_value() );
+    EXPECT( e->id == 7 );
+    EXPECT_NOT( u.has_value() );
+    EXPECT( u.error() == 'u' );
+
+    eic c{ u };
+
+    EXPECT_NOT( c.has_value() );
+    EXPECT( c.error() == 'u' );
+
+    c = e;
+
+    EXPECT( c.has_value() );
+    EXPECT( c->id == 7 );
+
+    c = unexpected_type<char>( 'x' );
+
+    EXPECT_NOT( c.has_value() );
+    EXPECT( c.error() == 'x' );
+
+    c.swap( e );
+
+    EXPECT( c.has_value() );
+    EXPECT( c->id == 7 );
+    EXPECT_NOT( e.has_value() );
+    EXPECT( e.error() == 'x' );
+#else
+    EXPECT( !!"niche_traits is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Uses the niche of the error to hold the state, if available (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    using niche::Error;
+    using eie = expected<int, Error>;
+
+    EXPECT( sizeof( eie ) == sizeof( Error ) );
+
+    eie e{ 7 };
+    eie u{ unexpect, Error{ 42, 0 } };
+
+    EXPECT( e.has_value() );
+    EXPECT( *e == 7 );
+    EXPECT_NOT( u.has_value() );
+    EXPECT( u.error().code == 42 );
+
+    eie c{ std::move( e ) };
+
+    EXPECT( c.has_value() );
+    EXPECT( *c == 7 );
+
+    c = u;
+
+    EXPECT_NOT( c.has_value() );
+    EXPECT( c.error().code == 42 );
+
+    c = 3;
+
+    EXPECT( c.has_value() );
+    EXPECT( *c == 3 );
+
+    c.swap( u );
+
+    EXPECT_NOT( c.has_value() );
+    EXPECT( c.error().code == 42 );
+    EXPECT( u.has_value() );
+    EXPECT( *u == 3 );
+#else
+    EXPECT( !!"niche_traits is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Destroys the value or error held in a niche layout (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    using niche::Tracked;
+    using niche::Error;
+    using ete = expected<Tracked, Error>;
+
+    EXPECT( sizeof( ete ) == sizeof( Error ) );
+    {
+        ete e{ Tracked( 1 ) };
+        ete u{ unexpect, Error{ 42, 0 } };
+
+        EXPECT( Tracked::instances == 1 );
+
+        u = e;
+
+        EXPECT( Tracked::instances == 2 );
+
+        e = unexpected_type<Error>( Error{ 1, 0 } );
+
+        EXPECT( Tracked::instances == 1 );
+    }
+    EXPECT( Tracked::instances == 0 );
+#else
+    EXPECT( !!"niche_traits is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected<void>: Uses the niche of the error to hold the state, if available (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    using niche::Error;
+    using eve = expected<void, Error>;
+
+    EXPECT( sizeof( eve ) == sizeof( Error ) );
+
+    eve e;
+    eve u{ unexpect, Error{ 42, 0 } };
+
+    EXPECT( e.has_value() );
+    EXPECT_NOT( u.has_value() );
+    EXPECT( u.error().code == 42 );
+
+    e.swap( u );
+
+    EXPECT_NOT( e.has_value() );
+    EXPECT( e.error().code == 42 );
+    EXPECT( u.has_value() );
+
+    u = e;
+
+    EXPECT_NOT( u.has_value() );
+    EXPECT( u.error().code == 42 );
+#else
+    EXPECT( !!"niche_traits is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Uses the category of std::error_code to hold the state, with nsel_CONFIG_NICHE_ERROR_CODE (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED && nsel_CONFIG_NICHE_ERROR_CODE
+    using eic = expected<int, std::error_code>;
+    using eve = expected<void, std::error_code>;
+
+    EXPECT( sizeof( eic ) == sizeof( std::error_code ) );
+    EXPECT( sizeof( eve ) == sizeof( std::error_code ) );
+
+    const std::error_code ec = std::make_error_code( std::errc::invalid_argument );
+
+    eic e{ 7 };
+    eic u{ unexpect, ec };
+    eic d{ unexpect };
+
+    EXPECT( e.has_value() );
+    EXPECT( *e == 7 );
+    EXPECT_NOT( u.has_value() );
+    EXPECT( u.error() == ec );
+    EXPECT( &u.error().category() == &std::generic_category() );
+    EXPECT_NOT( d.has_value() );
+    EXPECT( d.error() == std::error_code() );
+
+    e.swap( u );
+
+    EXPECT_NOT( e.has_value() );
+    EXPECT( e.error() == ec );
+    EXPECT( u.has_value() );
+    EXPECT( *u == 7 );
+
+    eve v;
+    eve w{ unexpect, ec };
+
+    EXPECT( v.has_value() );
+    EXPECT_NOT( w.has_value() );
+
+    v = w;
+
+    EXPECT_NOT( v.has_value() );
+    EXPECT( v.error() == ec );
+#else
+    EXPECT( !!"the niche of std::error_code is not used (nsel_CONFIG_NICHE_ERROR_CODE is 0, or using std::expected)." );
+#endif
+}
+
 // x.x.4.3 expected<> assignment
 
 CASE( "expected: Allows to copy-assign from expected, value" )
@@ -1003,6 +1283,88 @@ CASE( "expected: Allows to move-assign from move-only unexpected" )
     EXPECT( e.error() == 7 );
 }
 
+CASE( "expected: Allows to copy-assign from expected, reusing the storage of the value" )
+{
+    std::vector<int> v; v.reserve( 100 );
+
+    expected<std::vector<int>, int> a{ std::move( v ) };
+    expected<std::vector<int>, int> b{ in_place, 3u, 7 };
+
+    int const * data = a->data();
+
+    a = b;
+
+    EXPECT( a->size() == 3u );
+    EXPECT( a->data() == data );
+    EXPECT( a->capacity() >= 100u );
+}
+
+CASE( "expected: Allows to copy-assign from unexpected, reusing the storage of the error" )
+{
+    std::string s; s.reserve( 100 );
+
+    expected<int, std::string> e{ unexpect, std::move( s ) };
+    unexpected_type<std::string> u{ "error" };
+
+    char const * data = e.error().data();
+
+    e = u;
+
+    EXPECT( e.error() == "error" );
+    EXPECT( e.error().data() == data );
+}
+
+CASE( "expected: Allows to copy-assign from value, reusing the storage of the value" )
+{
+    std::vector<int> v; v.reserve( 100 );
+
+    expected<std::vector<int>, int> a{ std::move( v ) };
+    std::vector<int> const b( 3u, 7 );
+
+    int const * data = a->data();
+
+    a = b;
+
+    EXPECT( a->size() == 3u );
+    EXPECT( a->data() == data );
+    EXPECT( a->capacity() >= 100u );
+}
+
+namespace {
+
+// value with a throwing copy constructor and an optionally throwing move constructor:
+
+template< bool NothrowMove >
+struct ThrowOnCopy
+{
+    ThrowOnCopy() {}
+    ThrowOnCopy( ThrowOnCopy const & ) { throw std::runtime_error("copy"); }
+    ThrowOnCopy( ThrowOnCopy && ) noexcept( NothrowMove ) {}
+    ThrowOnCopy & operator=( ThrowOnCopy const & ) = default;
+    ThrowOnCopy & operator=( ThrowOnCopy && ) = default;
+};
+
+} // anonymous namespace
+
+CASE( "expected: Provides the strong exception guarantee for an assignment that changes the state" )
+{
+    using et = expected<ThrowOnCopy<true >, int>;
+    using eb = expected<ThrowOnCopy<false>, int>;
+
+    et vt{ in_place };
+    eb vb{ in_place };
+    et ut{ unexpect, 7 };
+    eb ub{ unexpect, 7 };
+
+    EXPECT_THROWS_AS( ut = vt, std::runtime_error );
+    EXPECT_THROWS_AS( ub = vb, std::runtime_error );
+
+    EXPECT( ! ut );
+    EXPECT( ! ub );
+    EXPECT( ut.error() == 7 );
+    EXPECT( ub.error() == 7 );
+}
+
 CASE( "expected: Allows to emplace value" )
 {
     expected<int, char> a;
@@ -1034,6 +1396,180 @@ CASE( "expected: Allows to emplace value from initializer_list" )
     EXPECT( e.value().c       == 'a');
 }
 
+namespace {
+
+// value that counts its moves, nothrow constructible:
+
+struct MoveCounted
+{
+    static int moves;
+
+    int v;
+
+    MoveCounted( int v_ ) noexcept : v( v_ ) {}
+    MoveCounted( MoveCounted && other ) noexcept : v( other.v ) { ++moves; }
+    MoveCounted & operator=( MoveCounted && other ) noexcept { v = other.v; ++moves; return *this; }
+};
+
+int MoveCounted::moves = 0;
+
+// value that may throw on construction:
+
+struct MayThrow
+{
+    int v;
+
+    MayThrow( int v_ ) : v( v_ ) { if ( v < 0 ) throw std::runtime_error("negative"); }
+    MayThrow( MayThrow && other ) noexcept : v( other.v ) {}
+};
+
+// non-movable value that counts its instances:
+
+struct NonMovableCounted
+{
+    static int instances;
+
+    NonMovableCounted() { ++instances; }
+    NonMovableCounted( NonMovableCounted && ) = delete;
+    ~NonMovableCounted() { --instances; }
+};
+
+int NonMovableCounted::instances = 0;
+
+} // anonymous namespace
+
+CASE( "expected: Allows to emplace value in place, without a temporary" )
+{
+    expected<MoveCounted, int> e{ unexpect, 7 };
+
+    MoveCounted::moves = 0;
+
+    e.emplace( 1 );
+    e.emplace( 2 );
+
+    EXPECT( e->v == 2 );
+    EXPECT( MoveCounted::moves == 0 );
+}
+
+CASE( "expected: Allows to emplace value that may throw, with the strong exception guarantee (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    expected<MayThrow, int> e{ unexpect, 7 };
+    expected<MayThrow, int> v{ in_place, 7 };
+
+    EXPECT_THROWS_AS( e.emplace( -1 ), std::runtime_error );
+    EXPECT_THROWS_AS( v.emplace( -1 ), std::runtime_error );
+
+    EXPECT( e.error() == 7 );
+    EXPECT( v->v      == 7 );
+
+    e.emplace( 42 );
+
+    EXPECT( e->v == 42 );
+#else
+    EXPECT( !!"emplace() requires a nothrow-constructible value (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Allows to emplace value from the result of a function (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    expected<int, int> e{ unexpect, 7 };
+    expected<MayThrow, int> v{ in_place, 7 };
+
+    auto ve = e.emplace_with( []{ return 42; } );
+
+    EXPECT_THROWS_AS( v.emplace_with( []{ return MayThrow( -1 ); } ), std::runtime_error );
+
+    EXPECT( ve == 42 );
+    EXPECT( e.value() == 42 );
+    EXPECT( v->v == 7 );
+#else
+    EXPECT( !!"emplace_with() is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Allows to emplace non-movable value from the result of a function (nonstd, C++17)" )
+{
+#if !nsel_USES_STD_EXPECTED && nsel_CPP17_OR_GREATER
+    expected<NonMovableNonCopyable, int> e{ unexpect, 7 };
+    expected<MoveCounted, int> m{ unexpect, 7 };
+
+    MoveCounted::moves = 0;
+
+    e.emplace_with( []() noexcept { return NonMovableNonCopyable(); } );
+    m.emplace_with( []() noexcept { return MoveCounted( 42 ); } );
+
+    EXPECT( e.has_value() );
+    EXPECT( m->v == 42 );
+    EXPECT( MoveCounted::moves == 0 );
+#else
+    EXPECT( !!"emplace_with() is not available (using std::expected or no C++17)." );
+#endif
+}
+
+CASE( "expected: Allows to emplace error (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    expected<int, MoveCounted> e{ 7 };
+
+    MoveCounted::moves = 0;
+
+    auto & ve = e.emplace_error( 1 );
+
+    EXPECT( ve.v == 1 );
+    EXPECT( ! e );
+
+    e.emplace_error( 2 );
+
+    EXPECT( e.error().v == 2 );
+    EXPECT( MoveCounted::moves == 0 );
+#else
+    EXPECT( !!"emplace_error() is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Allows to emplace error that may throw beside a non-movable value, with the strong exception guarantee (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    NonMovableCounted::instances = 0;
+    {
+        expected<NonMovableCounted, MayThrow> e{ in_place };
+        expected<NonMovableCounted, MayThrow> u{ unexpect, 7 };
+
+        EXPECT_THROWS_AS( e.emplace_error( -1 ), std::runtime_error );
+        EXPECT_THROWS_AS( u.emplace_error( -1 ), std::runtime_error );
+
+        EXPECT( e.has_value() );
+        EXPECT( u.error().v == 7 );
+        EXPECT( NonMovableCounted::instances == 1 );
+
+        e.emplace_error( 42 );
+
+        EXPECT( e.error().v == 42 );
+        EXPECT( NonMovableCounted::instances == 0 );
+    }
+    EXPECT( NonMovableCounted::instances == 0 );
+#else
+    EXPECT( !!"emplace_error() is not available (using std::expected)." );
+#endif
+}
+
+CASE( "expected: Allows to emplace error from initializer_list (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    expected<int, InitList> e{ 7 };
+
+    e.emplace_error( { 7, 8, 9 }, 'a' );
+
+    EXPECT( ! e );
+    EXPECT( e.error().vec[2] ==  9 );
+    EXPECT( e.error().c      == 'a');
+#else
+    EXPECT( !!"emplace_error() is not available (using std::expected)." );
+#endif
+}
+
 // x.x.4.4 expected<> swap
 
 CASE( "expected: Allows to be swapped" )
@@ -1292,6 +1828,44 @@ CASE( "expected: Throws bad_expected_access on value access when disengaged" )
     EXPECT_THROWS_AS( std::move(ec).value(), bad_expected_access<int> );
 }
 
+#if !nsel_USES_STD_EXPECTED
+
+namespace {
+
+struct contract_violated{};
+
+void throwing_handler( char const *, char const *, int )
+{
+    throw contract_violated{};
+}
+
+} // anonymous namespace
+
+#endif
+
+CASE( "expected: Allows to register a handler for contract violations (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    contract_violation_handler previous = set_contract_violation_handler( throwing_handler );
+
+    EXPECT( set_contract_violation_handler( previous ) == throwing_handler );
+
+# if nsel_CONFIG_CONTRACT_VIOLATION_HANDLER == nsel_CONTRACT_VIOLATION_CALL_HANDLER
+    set_contract_violation_handler( throwing_handler );
+
+    expected<int, int> e{ 7 };
+    expected<int, int> u{ unexpect, 7 };
+
+    EXPECT_THROWS_AS( *u, contract_violated );
+    EXPECT_THROWS_AS( e.error(), contract_violated );
+
+    set_contract_violation_handler( previous );
+# endif
+#else
+    EXPECT( !!"set_contract_violation_handler() is not available (using std::expected)." );
+#endif
+}
+
 #if nsel_P2505R >= 4
 CASE( "expected: Allows to observe its unexpected value, or fallback to the specified value with error_or" " [monadic p2505r4]")
 {
@@ -1414,8 +1988,331 @@ CASE( "expected: Allows to map errors with transform_error" " [monadic p2505r3]"
         EXPECT( ue.transform_error( to_43 ).error() == 43 );
     }
 }
+
+namespace {
+
+// error that counts its copies and moves:
+
+struct CountedError
+{
+    static int copies;
+    static int moves;
+
+    static void reset() { copies = moves = 0; }
+
+    int code;
+
+    CountedError( int c ) : code( c ) {}
+    CountedError( CountedError const & other ) : code( other.code ) { ++copies; }
+    CountedError( CountedError && other ) noexcept : code( other.code ) { ++moves; }
+};
+
+int CountedError::copies = 0;
+int CountedError::moves  = 0;
+
+// error converted from CountedError, counts its moves:
+
+struct OtherError
+{
+    static int moves;
+
+    int code;
+
+    OtherError( CountedError const & e ) : code( e.code ) {}
+    OtherError( CountedError && e ) : code( e.code ) {}
+    OtherError( OtherError const & other ) : code( other.code ) {}
+    OtherError( OtherError && other ) noexcept : code( other.code ) { ++moves; }
+};
+
+int OtherError::moves = 0;
+
+} // anonymous namespace
+
+CASE( "expected: Constructs the error in place when propagating it with transform and and_then" " [monadic p2505r3]" )
+{
+    using eic = expected<int, CountedError>;
+
+    const auto inc = []( int v ) { return v + 1; };
+    const auto check = []( int v ) { return eic( v ); };
+
+    eic ue{ unexpect, 7 };
+
+    CountedError::reset();
+    {
+        auto r = ue.transform( inc );
+
+        EXPECT( r.error().code == 7 );
+        EXPECT( CountedError::copies == 1 );
+#if nsel_CPP17_OR_GREATER
+        EXPECT( CountedError::moves  == 0 );
+#endif
+    }
+
+    CountedError::reset();
+    {
+        auto r = std::move( ue ).transform( inc ).transform( inc ).and_then( check );
+
+        EXPECT( r.error().code == 7 );
+        EXPECT( CountedError::copies == 0 );
+#if nsel_CPP17_OR_GREATER
+        EXPECT( CountedError::moves  == 3 );
+#endif
+    }
+}
+
+CASE( "expected: Constructs the error in place with transform_error" " [monadic p2505r3]" )
+{
+    const auto to_other = []( CountedError const & e ) { return OtherError( e ); };
+
+    expected<int, CountedError> ue{ unexpect, 7 };
+
+    CountedError::reset();
+    OtherError::moves = 0;
+
+    auto r = ue.transform_error( to_other );
+
+    EXPECT( r.error().code == 7 );
+    EXPECT( CountedError::copies == 0 );
+#if nsel_CPP17_OR_GREATER
+    EXPECT( OtherError::moves == 1 );
+#endif
+}
+
+CASE( "expected: Constructs the error in place when converting from expected<U,G>" )
+{
+    expected<int, CountedError> ue{ unexpect, 7 };
+
+    CountedError::reset();
+    OtherError::moves = 0;
+
+    expected<long, OtherError> r( std::move( ue ) );
+
+    EXPECT( r.error().code == 7 );
+    EXPECT( CountedError::copies == 0 );
+    EXPECT( CountedError::moves  == 0 );
+    EXPECT( OtherError::moves    == 0 );
+}
 #endif // nsel_P2505R >= 3
 
+// coroutine support:
+
+#if !nsel_USES_STD_EXPECTED && nsel_CONFIG_COROUTINES
+
+namespace coro {
+
+expected<int, std::string> parse( char const * text )
+{
+    if ( text[0] >= '0' && text[0] <= '9' )
+        return text[0] - '0';
+
+    return make_unexpected( std::string( "not a digit: " ) + text );
+}
+
+expected<void, std::string> check( bool ok )
+{
+    if ( ok )
+        return {};
+
+    return make_unexpected( std::string( "check failed" ) );
+}
+
+expected<int, std::string> sum( char const * a, char const * b, bool ok, int * reached )
+{
+    int x = co_await parse( a );
+    ++*reached;
+    co_await check( ok );
+    ++*reached;
+    expected<int, std::string> eb = parse( b );
+    int y = co_await eb;
+    ++*reached;
+    co_return x + y;
+}
+
+expected<void, std::string> verify( char const * a )
+{
+    co_await parse( a );
+    co_return {};
+}
+
+struct Local
+{
+    static int instances;
+
+    Local() { ++instances; }
+    ~Local() { --instances; }
+};
+
+int Local::instances = 0;
+
+expected<int, std::string> scoped( char const * a, bool raise )
+{
+    Local local;
+    int x = co_await parse( a );
+
+    if ( raise )
+        throw std::runtime_error( "raised" );
+
+    co_return x;
+}
+
+} // namespace coro
+
+#endif // nsel_CONFIG_COROUTINES
+
+CASE( "expected: Allows a coroutine to co_await an expected and yield its value (nonstd, C++20)" )
+{
+#if !nsel_USES_STD_EXPECTED && nsel_CONFIG_COROUTINES
+    int reached = 0;
+    expected<int, std::string> e = coro::sum( "4", "2", true, &reached );
+
+    EXPECT( e.has_value() );
+    EXPECT( *e == 6 );
+    EXPECT( reached == 3 );
+    EXPECT( coro::verify( "7" ).has_value() );
+#else
+    EXPECT( !!"coroutine support is not available (no C++20, or using std::expected)." );
+#endif
+}
+
+CASE( "expected: Allows a coroutine to co_await an expected and complete with its error (nonstd, C++20)" )
+{
+#if !nsel_USES_STD_EXPECTED && nsel_CONFIG_COROUTINES
+    int reached = 0;
+    expected<int, std::string> ea = coro::sum( "x", "2", true, &reached );
+
+    EXPECT( ea.error() == "not a digit: x" );
+    EXPECT( reached == 0 );
+
+    reached = 0;
+    expected<int, std::string> ec = coro::sum( "4", "2", false, &reached );
+
+    EXPECT( ec.error() == "check failed" );
+    EXPECT( reached == 1 );
+
+    reached = 0;
+    expected<int, std::string> eb = coro::sum( "4", "y", true, &reached );
+
+    EXPECT( eb.error() == "not a digit: y" );
+    EXPECT( reached == 2 );
+
+    EXPECT( coro::verify( "z" ).error() == "not a digit: z" );
+#else
+    EXPECT( !!"coroutine support is not available (no C++20, or using std::expected)." );
+#endif
+}
+
+CASE( "expected: Destroys the coroutine and its locals, also with an error or an exception (nonstd, C++20)" )
+{
+#if !nsel_USES_STD_EXPECTED && nsel_CONFIG_COROUTINES
+    EXPECT( coro::scoped( "3", false ).value() == 3 );
+    EXPECT( coro::Local::instances == 0 );
+
+    EXPECT( coro::scoped( "x", false ).error() == "not a digit: x" );
+    EXPECT( coro::Local::instances == 0 );
+
+    EXPECT_THROWS_AS( (void) coro::scoped( "3", true ), std::runtime_error );
+    EXPECT( coro::Local::instances == 0 );
+#else
+    EXPECT( !!"coroutine support is not available (no C++20, or using std::expected)." );
+#endif
+}
+
+// early return propagation:
+
+namespace trying {
+
+struct Counted
+{
+    static int copies;
+    static int moves;
+
+    static void reset() { copies = moves = 0; }
+
+    int v;
+
+    Counted( int v_ ) : v( v_ ) {}
+    Counted( Counted const & other ) : v( other.v ) { ++copies; }
+    Counted( Counted && other ) noexcept : v( other.v ) { ++moves; }
+};
+
+int Counted::copies = 0;
+int Counted::moves  = 0;
+
+expected<Counted, Counted> make( int v )
+{
+    if ( v < 0 )
+        return expected<Counted, Counted>( unexpect, -v );
+
+    return expected<Counted, Counted>( in_place, v );
+}
+
+expected<int, Counted> twice( int v )
+{
+    nsel_TRY( Counted c, make( v ) );
+    return 2 * c.v;
+}
+
+expected<void, Counted> check( int v )
+{
+    nsel_TRY_VOID( make( v ) );
+    return {};
+}
+
+expected<int, Counted> layered( int v, int * reached )
+{
+    nsel_TRY( int x, twice( v ) );
+    ++*reached;
+    nsel_TRY_VOID( check( v - 10 ) );
+    ++*reached;
+    nsel_TRY( x, twice( x ) );
+    return x;
+}
+
+expected<int, Counted> from_lvalue( expected<Counted, Counted> const & e )
+{
+    nsel_TRY( Counted c, e );
+    return c.v;
+}
+
+} // namespace trying
+
+CASE( "expected: Allows to propagate an error with nsel_TRY() and nsel_TRY_VOID()" )
+{
+    int reached = 0;
+
+    EXPECT( trying::layered( 12, &reached ).value() == 48 );
+    EXPECT( reached == 2 );
+
+    reached = 0;
+    EXPECT( trying::layered( -3, &reached ).error().v == 3 );
+    EXPECT( reached == 0 );
+
+    reached = 0;
+    EXPECT( trying::layered( 7, &reached ).error().v == 3 );
+    EXPECT( reached == 1 );
+}
+
+CASE( "expected: Moves value and error of an rvalue through nsel_TRY(), copies those of an lvalue" )
+{
+    trying::Counted::reset();
+
+    EXPECT( trying::twice( 21 ).value() == 42 );
+    EXPECT( trying::twice( -5 ).error().v == 5 );
+    EXPECT( trying::check( -6 ).error().v == 6 );
+    EXPECT( trying::Counted::copies == 0 );
+
+    expected<trying::Counted, trying::Counted> value( in_place, 7 );
+    expected<trying::Counted, trying::Counted> error( unexpect, 8 );
+
+    trying::Counted::reset();
+
+    EXPECT( trying::from_lvalue( value ).value() == 7 );
+    EXPECT( trying::from_lvalue( error ).error().v == 8 );
+    EXPECT( trying::Counted::copies == 2 );
+    EXPECT( value->v == 7 );
+    EXPECT( error.error().v == 8 );
+}
+
 // -----------------------------------------------------------------------
 // expected<void> specialization
 
@@ -1530,6 +2427,21 @@ CASE( "expected<void>: Allows to in-place-construct error from initializer_list"
     EXPECT(  e.error().c       == 'a');
 }
 
+CASE( "expected<void>: Is trivially copyable and destructible if E is" )
+{
+#if !nsel_USES_STD_EXPECTED && !nsel_HAVE_IS_TRIVIALLY_COPYABLE
+    EXPECT( !!"std::is_trivially_copyable is not available (no C++11 library support)." );
+#else
+    using evi = expected<void, int>;
+    using evs = expected<void, std::string>;
+
+    EXPECT(     std::is_trivially_destructible< evi >::value );
+    EXPECT(     std::is_trivially_copyable< evi >::value );
+    EXPECT_NOT( std::is_trivially_destructible< evs >::value );
+    EXPECT_NOT( std::is_trivially_copyable< evs >::value );
+#endif
+}
+
 // x.x.4.3 expected<void> assignment
 
 CASE( "expected<void>: Allows to copy-assign from expected, value" )
@@ -1574,6 +2486,36 @@ CASE( "expected<void>: Allows to move-assign from expected, error" )
     EXPECT(  b.error() == 7 );
 }
 
+CASE( "expected<void>: Allows to copy-assign from unexpected, reusing the storage of the error" )
+{
+    std::string s; s.reserve( 100 );
+
+    expected<void, std::string> e{ unexpect, std::move( s ) };
+    unexpected_type<std::string> u{ "an error that does not fit in a short string" };
+
+    char const * data = e.error().data();
+
+    e = u;
+
+    EXPECT( e.error() == "an error that does not fit in a short string" );
+    EXPECT( e.error().data() == data );
+}
+
+CASE( "expected<void>: Allows to copy-assign from expected, value to error and back" )
+{
+    expected<void, int> a;
+    expected<void, int> b{ unexpect, 7 };
+
+    a = b;
+
+    EXPECT( !a              );
+    EXPECT(  a.error() == 7 );
+
+    b = expected<void, int>{};
+
+    EXPECT( b );
+}
+
 CASE( "expected<void>: Allows to emplace value" )
 {
     expected<void, int> a{ unexpect, 7 };
@@ -1583,6 +2525,28 @@ CASE( "expected<void>: Allows to emplace value" )
     EXPECT( a );
 }
 
+CASE( "expected<void>: Allows to emplace error (nonstd)" )
+{
+#if !nsel_USES_STD_EXPECTED
+    expected<void, int> e;
+
+    e.emplace_error( 7 );
+
+    EXPECT( ! e );
+    EXPECT( e.error() == 7 );
+
+    e.emplace_error( 42 );
+
+    EXPECT( e.error() == 42 );
+
+    e.emplace();
+
+    EXPECT( e );
+#else
+    EXPECT( !!"emplace_error() is not available (using std::expected)." );
+#endif
+}
+
 // x.x.4.4 expected<void> swap
 
 CASE( "expected<void>: Allows to be swapped" )
@@ -1836,6 +2800,32 @@ CASE( "expected<void>: Allows to map unexpected error value via transform_error"
         EXPECT( ue.transform_error( map_to_my_error ).error() == my_error::einval );
     }
 }
+
+CASE( "expected<void>: Constructs the error in place when propagating it with transform" " [monadic p2505r3]" )
+{
+    const auto make_int = [] { return 7; };
+
+    expected<void, CountedError> ue{ unexpect, 7 };
+
+    CountedError::reset();
+    {
+        auto r = ue.transform( make_int );
+
+        EXPECT( r.error().code == 7 );
+        EXPECT( CountedError::copies == 1 );
+    }
+
+    CountedError::reset();
+    {
+        auto r = std::move( ue ).transform( make_int );
+
+        EXPECT( r.error().code == 7 );
+        EXPECT( CountedError::copies == 0 );
+#if nsel_CPP17_OR_GREATER
+        EXPECT( CountedError::moves  == 1 );
+#endif
+    }
+}
 #endif // nsel_P2505R >= 3
 
 // [expected<> unwrap()]